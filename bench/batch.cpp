@@ -0,0 +1,86 @@
+/*
+ * Scaling of optparse_batch_blobs() with thread count.
+ *
+ * One million recorded command lines are parsed with the same table and the
+ * results stored per line. Speedup should track the thread count up to the
+ * number of physical cores; a flat column points at shared cache lines.
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+#include "bench.h"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "optparse/batch.h"
+
+static const optparse_long_t kLongopts[] = {
+    {"all", 'a', OPTPARSE_NONE},
+    {"file", 'f', OPTPARSE_REQUIRED},
+    {"jobs", 'j', OPTPARSE_REQUIRED},
+    {"verbose", 'v', OPTPARSE_NONE},
+    {nullptr, 0, OPTPARSE_NONE},
+};
+
+struct Result {
+    int options;
+    int positionals;
+};
+
+static int visit(optparse_t* options, int line, void* userdata) {
+    Result& r = static_cast<Result*>(userdata)[line];
+    r         = {0, 0};
+    for (int c; (c = optparse_long(options, kLongopts, nullptr)) != -1;) {
+        if (c == 1) {
+            ++r.positionals;
+        } else {
+            ++r.options;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const int           lines = 1000000;
+    std::string         storage;
+    std::vector<size_t> offsets, lens;
+    for (int i = 0; i < lines; ++i) {
+        const size_t start = storage.size();
+        storage.append("job").push_back('\0');
+        for (int k = 0; k < 2 + i % 9; ++k) {
+            switch ((i + k) % 4) {
+                case 0: storage.append("-av"); break;
+                case 1: storage.append("--file=input" + std::to_string(k)); break;
+                case 2: storage.append("--jobs").append(1, '\0').append(std::to_string(i % 64)); break;
+                default: storage.append("target" + std::to_string(k)); break;
+            }
+            storage.push_back('\0');
+        }
+        offsets.push_back(start);
+        lens.push_back(storage.size() - start);
+    }
+    std::vector<char*> blobs;
+    for (size_t off : offsets) { blobs.push_back(&storage[off]); }
+    std::vector<Result> results(lines);
+
+    /* powers of two up to the core count, or up to argv[1] */
+    const int        cores       = (int)std::max(1u, std::thread::hardware_concurrency());
+    const int        max_threads = argc > 1 ? std::max(1, atoi(argv[1])) : cores;
+    std::vector<int> counts;
+    for (int t = 1; t < max_threads; t *= 2) { counts.push_back(t); }
+    counts.push_back(max_threads);
+
+    double base = 0;
+    printf("%8s %12s %14s %9s\n", "threads", "total ms", "lines/s", "speedup");
+    for (int t : counts) {
+        double ns = bench::best_ns(5, [&] {
+            optparse_batch_blobs(blobs.data(), lens.data(), lines, t, visit, results.data());
+        });
+        if (t == 1) { base = ns; }
+        printf("%8d %12.1f %14.0f %8.2fx\n", t, ns / 1e6, lines / (ns / 1e9), base / ns);
+        bench::keep(results[lines - 1].options);
+    }
+    return 0;
+}
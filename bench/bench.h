@@ -0,0 +1,60 @@
+#ifndef OPTPARSE_BENCH_H
+#define OPTPARSE_BENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/** Owns the strings of a synthetic argv and exposes a NULL-terminated char** view. */
+class Argv {
+public:
+    void push(std::string s) { _strings.push_back(std::move(s)); }
+
+    size_t size() const { return _strings.size(); }
+
+    /** Rebuild the pointer array; call before every parse since permutation reorders it. */
+    char** reset() {
+        _ptrs.clear();
+        _ptrs.push_back(const_cast<char*>("prog"));
+        for (auto& s : _strings) { _ptrs.push_back(&s[0]); }
+        _ptrs.push_back(nullptr);
+        return _ptrs.data();
+    }
+
+private:
+    std::vector<std::string> _strings;
+    std::vector<char*>       _ptrs;
+};
+
+/** Best-of-@p reps wall time of @p fn in nanoseconds. */
+template <typename Fn>
+double best_ns(int reps, Fn&& fn) {
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        auto   t0 = std::chrono::steady_clock::now();
+        fn();
+        auto   t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        if (ns < best) { best = ns; }
+    }
+    return best;
+}
+
+/** Keep @p value observable so the optimizer cannot drop the measured work. */
+template <typename T>
+void keep(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile T sink;
+    sink = value;
+    (void)sink;
+#endif
+}
+
+}  // namespace bench
+
+#endif  // OPTPARSE_BENCH_H
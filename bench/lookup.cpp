@@ -0,0 +1,77 @@
+/*
+ * Cost of resolving one "--name" against tables of growing size.
+ *
+ * Each row parses the same argv of long options, drawn uniformly from the
+ * table, with optparse_long() (linear scan), optparse_long_indexed()
+ * (binary search), optparse_long_packed() (16-byte prefix rows) and an
+ * OPTPARSE_TABLE() perfect hash. The tables are generated at compile time
+ * from a fixed list of names, many of which share their first bytes.
+ */
+#include <random>
+
+#include "bench.h"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "optparse/optparse.hpp"
+
+#define NAMES16(p)                                                                                                \
+    {p "alpha", 0, OPTPARSE_NONE}, {p "bravo", 0, OPTPARSE_NONE}, {p "charlie", 0, OPTPARSE_NONE},                 \
+        {p "delta", 0, OPTPARSE_NONE}, {p "echo", 0, OPTPARSE_NONE}, {p "foxtrot", 0, OPTPARSE_NONE},              \
+        {p "golf", 0, OPTPARSE_NONE}, {p "hotel", 0, OPTPARSE_NONE}, {p "india", 0, OPTPARSE_NONE},                \
+        {p "juliett", 0, OPTPARSE_NONE}, {p "kilo", 0, OPTPARSE_NONE}, {p "lima", 0, OPTPARSE_NONE},               \
+        {p "mike", 0, OPTPARSE_NONE}, {p "november", 0, OPTPARSE_NONE}, {p "oscar", 0, OPTPARSE_NONE},             \
+        {p "papa", 0, OPTPARSE_NONE}
+#define NAMES64(p) NAMES16(p "build-"), NAMES16(p "cache-"), NAMES16(p "debug-"), NAMES16(p "output-")
+
+static constexpr optparse_long_t kLongopts16[]  = {NAMES16(""), {nullptr, 0, OPTPARSE_NONE}};
+static constexpr optparse_long_t kLongopts64[]  = {NAMES64(""), {nullptr, 0, OPTPARSE_NONE}};
+static constexpr optparse_long_t kLongopts256[] = {NAMES64("a-"), NAMES64("b-"), NAMES64("c-"), NAMES64("d-"),
+                                                   {nullptr, 0, OPTPARSE_NONE}};
+
+template <class Table, std::size_t N>
+static void run(const char* label, const optparse_long_t (&longopts)[N]) {
+    const int count = (int)N - 1;
+    const int n     = 1 << 16;
+
+    std::mt19937 rng(1);
+    bench::Argv  av;
+    for (int i = 0; i < n; ++i) { av.push(std::string("--") + longopts[rng() % count].longname); }
+
+    std::vector<int> order(count);
+    optparse_index_t index;
+    optparse_index_init(&index, longopts, order.data(), count);
+    std::vector<optparse_packed_row_t> rows(count);
+    optparse_packed_t                  packed;
+    optparse_packed_init(&packed, longopts, rows.data(), count);
+
+    auto loop = [&](int (*next)(optparse_t*, const void*), const void* ctx) {
+        return bench::best_ns(11, [&] {
+            optparse_t options;
+            optparse_init(&options, av.reset());
+            int sum = 0;
+            for (int c; (c = next(&options, ctx)) != -1;) { sum += c; }
+            bench::keep(sum);
+        });
+    };
+    const double linear = loop([](optparse_t* o, const void* lo) {
+        return optparse_long(o, static_cast<const optparse_long_t*>(lo), nullptr);
+    }, longopts);
+    const double indexed = loop([](optparse_t* o, const void* ix) {
+        return optparse_long_indexed(o, static_cast<const optparse_index_t*>(ix), nullptr);
+    }, &index);
+    const double prefixed = loop([](optparse_t* o, const void* pk) {
+        return optparse_long_packed(o, static_cast<const optparse_packed_t*>(pk), nullptr);
+    }, &packed);
+    const double hashed = loop([](optparse_t* o, const void*) { return Table::parse(o, nullptr); }, nullptr);
+    printf("%-8s %12.2f %12.2f %12.2f %12.2f\n", label, linear / n, indexed / n, prefixed / n, hashed / n);
+}
+
+int main() {
+    printf("%-8s %12s %12s %12s %12s\n", "options", "linear ns", "index ns", "packed ns", "table ns");
+    run<OPTPARSE_TABLE(kLongopts16)>("16", kLongopts16);
+    run<OPTPARSE_TABLE(kLongopts64)>("64", kLongopts64);
+    run<OPTPARSE_TABLE(kLongopts256)>("256", kLongopts256);
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Cold-cache parse of a large argv whose strings are scattered over the heap.
+ *
+ * Before every timed run the caches are flushed by streaming through a
+ * buffer larger than the last-level cache, so each string is a miss the
+ * first time it is read. "plain" is the optparse_long() loop on its own;
+ * the other rows classify first and parse with optparse_classes(), with
+ * a serial loop, with optparse_prescan()'s prefetching loop, and with
+ * prescan also measuring every token.
+ */
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <random>
+
+#include "bench.h"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+static const optparse_long_t kLongopts[] = {
+    {"all", 'a', OPTPARSE_NONE},
+    {"file", 'f', OPTPARSE_REQUIRED},
+    {nullptr, 0, OPTPARSE_NONE},
+};
+
+static std::vector<char> g_flush(256u << 20);
+
+/* best-of-@p reps wall time of @p fn, with the caches flushed before each run */
+template <typename Fn>
+static double cold_ns(int reps, Fn&& fn) {
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        for (size_t i = 0; i < g_flush.size(); i += 64) { g_flush[i] = (char)(g_flush[i] + 1); }
+        const double ns = bench::best_ns(1, fn);
+        if (ns < best) { best = ns; }
+    }
+    return best;
+}
+
+static int parse(char** argv, int argc, const unsigned char* classes) {
+    std::vector<int> positions(argc);
+    optparse_t       options;
+    optparse_mode_t  mode;
+    int              count = 0;
+    optparse_init(&options, argv);
+    optparse_record(&options, &mode, positions.data(), argc);
+    if (classes) { optparse_classes(&options, &mode, classes, argc); }
+    while (optparse_long(&options, kLongopts, nullptr) != -1) { ++count; }
+    return count;
+}
+
+int main() {
+    const int n = 1 << 20;
+
+    /* one heap block per token, allocated in shuffled order so neighbours in argv are far apart in memory */
+    std::vector<std::unique_ptr<char[]>> strings(n);
+    std::vector<int>                     order(n);
+    for (int i = 0; i < n; ++i) { order[i] = i; }
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    for (int i : order) {
+        const std::string s = i % 16 == 0 ? "--file=input" + std::to_string(i)
+                              : i % 8 == 0  ? "-a"
+                                            : "target" + std::to_string(i);
+        strings[i].reset(new char[s.size() + 1]);
+        memcpy(strings[i].get(), s.c_str(), s.size() + 1);
+    }
+    std::vector<char*> argv = {const_cast<char*>("prog")};
+    for (auto& s : strings) { argv.push_back(s.get()); }
+    argv.push_back(nullptr);
+    const int argc = (int)argv.size() - 1;
+
+    std::vector<unsigned char> classes(argc);
+    std::vector<size_t>        lengths(argc);
+
+    printf("%-26s %12s %10s\n", "variant", "total ms", "ns/token");
+    auto report = [&](const char* name, double ns) { printf("%-26s %12.2f %10.2f\n", name, ns / 1e6, ns / argc); };
+
+    report("plain", cold_ns(5, [&] { bench::keep(parse(argv.data(), argc, nullptr)); }));
+    report("serial classify + parse", cold_ns(5, [&] {
+               for (int i = 0; i < argc; ++i) {
+                   const char* a = argv[i];
+                   classes[i]    = a[0] != '-' || a[1] == '\0' ? OPTPARSE_CLASS_POSITIONAL
+                                   : a[1] != '-'              ? OPTPARSE_CLASS_SHORT
+                                   : a[2] == '\0'             ? OPTPARSE_CLASS_DASHDASH
+                                                              : OPTPARSE_CLASS_LONG;
+               }
+               bench::keep(parse(argv.data(), argc, classes.data()));
+           }));
+    report("prescan + parse", cold_ns(5, [&] {
+               optparse_prescan(argv.data(), 0, argc, classes.data(), nullptr);
+               bench::keep(parse(argv.data(), argc, classes.data()));
+           }));
+    report("prescan with lengths", cold_ns(5, [&] {
+               optparse_prescan(argv.data(), 0, argc, classes.data(), lengths.data());
+               bench::keep(lengths[argc - 1]);
+           }));
+    return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * Scaling of a full optparse_long() loop with argv size.
+ *
+ * Every shape should report a roughly constant ns/token as argv grows; a
+ * rising column means some element is being rescanned or moved per option.
+ */
+#include "bench.h"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+static const optparse_long_t kLongopts[] = {
+    {"all", 'a', OPTPARSE_NONE},
+    {"file", 'f', OPTPARSE_REQUIRED},
+    {nullptr, 0, OPTPARSE_NONE},
+};
+
+enum Shape { LEADING, INTERLEAVED, TRAILING };
+
+static bench::Argv make_argv(Shape shape, int n) {
+    bench::Argv av;
+    for (int i = 0; i < n; ++i) {
+        const bool positional = shape == LEADING ? i < n / 2 : shape == TRAILING ? i >= n / 2 : i % 2 == 0;
+        if (positional) {
+            av.push("file" + std::to_string(i));
+        } else {
+            av.push(i % 3 ? "-a" : "--file=x");
+        }
+    }
+    return av;
+}
+
+int main() {
+    const char* names[] = {"leading positionals", "interleaved", "trailing positionals"};
+
+    printf("%-22s %10s %12s %10s\n", "shape", "tokens", "total us", "ns/token");
+    for (int shape = LEADING; shape <= TRAILING; ++shape) {
+        for (int n = 1 << 12; n <= 1 << 20; n <<= 2) {
+            bench::Argv av = make_argv(static_cast<Shape>(shape), n);
+            double      ns = bench::best_ns(5, [&] {
+                optparse_t options;
+                optparse_init(&options, av.reset());
+                int count = 0;
+                while (optparse_long(&options, kLongopts, nullptr) != -1) { ++count; }
+                while (optparse_arg(&options)) { ++count; }
+                bench::keep(count);
+            });
+            printf("%-22s %10d %12.1f %10.2f\n", names[shape], n, ns / 1e3, ns / n);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * Cost of one long option as its inline value and its name grow.
+ *
+ * The "value" rows parse --payload=<n bytes>; ns/option should stay flat
+ * as n grows. The "name" rows match a name of n bytes against a table of
+ * near misses sharing all but the last byte.
+ */
+#include "bench.h"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+static int parse(char* arg, const optparse_long_t* longopts) {
+    char*      argv[] = {const_cast<char*>("prog"), arg, nullptr};
+    optparse_t options;
+    optparse_init(&options, argv);
+    return optparse_long(&options, longopts, nullptr);
+}
+
+int main() {
+    const int iters = 100000;
+
+    printf("%-8s %10s %12s\n", "row", "bytes", "ns/option");
+    static const optparse_long_t payload[] = {
+        {"payload", 'p', OPTPARSE_REQUIRED},
+        {nullptr, 0, OPTPARSE_NONE},
+    };
+    for (size_t n = 16; n <= (1u << 22); n <<= 3) {
+        std::string arg = "--payload=" + std::string(n, 'v');
+        double      ns  = bench::best_ns(5, [&] {
+            for (int i = 0; i < iters; ++i) { bench::keep(parse(&arg[0], payload)); }
+        });
+        printf("%-8s %10zu %12.2f\n", "value", n, ns / iters);
+    }
+
+    for (size_t n = 4; n <= 64; n <<= 1) {
+        /* eight names that differ only in their last byte; the argument matches the last one */
+        std::vector<std::string>     names;
+        std::vector<optparse_long_t> longopts;
+        for (char c = 'a'; c < 'i'; ++c) { names.push_back(std::string(n - 1, 'n') + c); }
+        for (auto& name : names) { longopts.push_back({name.c_str(), 'n', OPTPARSE_NONE}); }
+        longopts.push_back({nullptr, 0, OPTPARSE_NONE});
+        std::string arg = "--" + names.back();
+        double      ns  = bench::best_ns(5, [&] {
+            for (int i = 0; i < iters; ++i) { bench::keep(parse(&arg[0], longopts.data())); }
+        });
+        printf("%-8s %10zu %12.2f\n", "name", n, ns / iters);
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+enum {
+    OPT_AMEND,
+    OPT_COLOR,
+    OPT_DELAY,
+    OPT_INCLUDE,
+    OPT_VERBOSE,
+    OPT_HELP,
+    OPT_COUNT,
+};
+
+struct config {
+    int             amend;
+    int             verbose;
+    char*           color;
+    long            delay;
+    optparse_list_t include;
+};
+
+static void out(const char* s, int len, void* f) {
+    fwrite(s, 1, (size_t)len, (FILE*)f);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    optparse_long_t longopts[] = {
+        [OPT_AMEND]   = {"amend", 'a', OPTPARSE_NONE, "amend the previous commit", NULL},
+        [OPT_COLOR]   = {"color", 'c', OPTPARSE_REQUIRED, "use colored output", "COLOR"},
+        [OPT_DELAY]   = {"delay", 0, OPTPARSE_OPTIONAL, "delay with optional value", "MS"},
+        [OPT_INCLUDE] = {"include", 'I', OPTPARSE_REQUIRED, "add a directory, may be repeated", "DIR"},
+        [OPT_VERBOSE] = {"verbose", 'v', OPTPARSE_NONE, "more output, may be repeated", NULL},
+        [OPT_HELP]    = {"help", 'h', OPTPARSE_NONE, "display this help message and exit", NULL},
+        [OPT_COUNT]   = {0},
+    };
+
+    struct config   config = {0, 0, "white", 0, {0}};
+    optparse_bind_t binds[OPT_COUNT] = {
+        [OPT_AMEND]   = {OPTPARSE_BIND_FLAG, &config.amend},
+        [OPT_COLOR]   = {OPTPARSE_BIND_STRING, &config.color},
+        [OPT_DELAY]   = {OPTPARSE_BIND_INT, &config.delay},
+        [OPT_INCLUDE] = {OPTPARSE_BIND_APPEND, &config.include},
+        [OPT_VERBOSE] = {OPTPARSE_BIND_COUNT, &config.verbose},
+    };
+
+    static char      mem[4096];
+    optparse_arena_t arena;
+    optparse_t       options;
+    char*            arg;
+    int              id;
+
+    optparse_arena_init(&arena, mem, sizeof(mem));
+    optparse_init(&options, argv);
+    while ((id = optparse_long_bind(&options, longopts, binds, &arena)) != OPTPARSE_ID_DONE) {
+        if (id == OPT_HELP) {
+            optparse_usage(out, stderr, "bind", longopts, -1, "[args...]");
+            fprintf(stderr, "\nOptions:\n");
+            optparse_help(out, stderr, longopts, -1, NULL);
+            fprintf(stderr, "\n");
+            exit(EXIT_SUCCESS);
+        }
+        fprintf(stderr, "bind: %s\n", options.errmsg);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Final configuration:\n");
+    printf("  amend: %s\n", config.amend ? "true" : "false");
+    printf("  verbose: %d\n", config.verbose);
+    printf("  color: %s\n", config.color);
+    printf("  delay: %ld\n", config.delay);
+    for (int i = 0; i < config.include.count; ++i) { printf("  include: %s\n", config.include.items[i]); }
+
+    printf("\nRemaining arguments:\n");
+    while ((arg = optparse_arg(&options))) { printf("  %s\n", arg); }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "optparse/proc.h"
+
+enum {
+    OPT_CONFIG = 128,
+    OPT_PORT,
+};
+
+/* flags looked for in every process's command line; everything else is ignored */
+static const optparse_long_t kTargetOpts[] = {
+    {"config", OPT_CONFIG, OPTPARSE_REQUIRED, NULL, NULL},
+    {"port", OPT_PORT, OPTPARSE_REQUIRED, NULL, NULL},
+    {0},
+};
+
+typedef struct report {
+    bool          print;
+    unsigned long matches;
+} report_t;
+
+static int visit(optparse_proc_t* scan, optparse_t* options, void* userdata) {
+    report_t*   report = (report_t*)userdata;
+    const char* config = NULL;
+    const char* port   = NULL;
+    int         option;
+
+    /* other programs' options are unknown to us: skip errors and keep going */
+    while ((option = optparse_long(options, kTargetOpts, NULL)) != -1) {
+        switch (option) {
+            case OPT_CONFIG: config = options->optarg; break;
+            case OPT_PORT: port = options->optarg; break;
+        }
+    }
+    if (config || port) {
+        ++report->matches;
+        if (report->print) {
+            printf("%7d  %-24s config=%s port=%s\n", scan->pid, options->argv[0], config ? config : "-",
+                   port ? port : "-");
+        }
+    }
+    return 0;
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void out(const char* s, int len, void* f) {
+    fwrite(s, 1, (size_t)len, (FILE*)f);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    optparse_long_t longopts[] = {
+        {"count", 'n', OPTPARSE_REQUIRED, "repeat the scan N times (default 1)", "N"},
+        {"quiet", 'q', OPTPARSE_NONE, "only report throughput", NULL},
+        {"help", 'h', OPTPARSE_NONE, "display this help message and exit", NULL},
+        {0},
+    };
+
+    int             count  = 1;
+    report_t        report = {true, 0};
+    int             option;
+    optparse_t      options;
+    optparse_proc_t scan;
+
+    optparse_init(&options, argv);
+    while ((option = optparse_long(&options, longopts, NULL)) != -1) {
+        switch (option) {
+            case 'n': count = atoi(options.optarg); break;
+            case 'q': report.print = false; break;
+            case 'h':
+                optparse_usage(out, stderr, "proc_scan", longopts, -1, NULL);
+                fprintf(stderr, "\nList processes started with --config or --port.\n\nOptions:\n");
+                optparse_help(out, stderr, longopts, -1, NULL);
+                exit(EXIT_SUCCESS);
+                break;
+            case '?': fprintf(stderr, "proc_scan: %s\n", options.errmsg); exit(EXIT_FAILURE);
+        }
+    }
+
+    optparse_proc_init(&scan);
+    const double start = now();
+    for (int i = 0; i < count; ++i) {
+        if (optparse_proc_scan(&scan, visit, &report) < 0) {
+            fprintf(stderr, "proc_scan: cannot read /proc\n");
+            exit(EXIT_FAILURE);
+        }
+        report.print = false; /* list matches once, then just measure */
+    }
+    const double elapsed = now() - start;
+
+    fprintf(stderr, "%lu processes (%lu skipped), %lu cmdline bytes in %.3f s: %.0f processes/s, %lu matches\n",
+            scan.visited, scan.skipped, scan.bytes, elapsed, elapsed > 0 ? (double)scan.visited / elapsed : 0.0,
+            report.matches);
+    optparse_proc_free(&scan);
+    return 0;
+}
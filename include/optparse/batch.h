@@ -0,0 +1,425 @@
+/**
+ * @file batch.h
+ * @brief Multi-threaded batch parsing of independent command lines for optparse.
+ *
+ * optparse_batch_argv() and optparse_batch_blobs() run a callback once per
+ * command line, spread over a pool of threads. Each callback gets a parser
+ * already set up over its line and runs its own optparse_long() loop; it
+ * should write what it finds into a slot indexed by the line number, so
+ * nothing is shared between lines. optparse_batch_classify() uses the same
+ * pool to pre-classify the tokens of a single very large argv.
+ *
+ * Lines are split into one contiguous range per thread. A thread takes
+ * OPTPARSE_BATCH_CHUNK lines at a time from the front of its own range and,
+ * once that is empty, steals the back half of another thread's range. Each
+ * thread's range and parser state sit in their own cache lines, so threads
+ * only touch shared memory when they take a chunk.
+ *
+ * Like response.h this module allocates and uses the OS thread API. Include
+ * it after defining OPTPARSE_IMPLEMENTATION in the same source file that
+ * implements optparse.h; POSIX builds link with -pthread.
+ *
+ * This is free and unencumbered software released into the public domain.
+ */
+#ifndef OPTPARSE_BATCH_H
+#define OPTPARSE_BATCH_H
+
+#include <stddef.h>
+
+#include "optparse.h"
+
+#ifndef OPTPARSE_BATCH_CHUNK
+#define OPTPARSE_BATCH_CHUNK 64
+#endif
+
+#ifndef OPTPARSE_BATCH_WINDOW
+#define OPTPARSE_BATCH_WINDOW 8
+#endif
+
+#ifndef OPTPARSE_BATCH_TOKENS
+#define OPTPARSE_BATCH_TOKENS 4096
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Callback invoked once per command line, possibly from several threads at once.
+ * @param options  parser over the line; argv[0] is its program name
+ * @param line     index of the line in the batch
+ * @param userdata opaque context passed to the batch function
+ * @return 0 to continue, non-zero to stop the batch
+ */
+typedef int (*optparse_batch_cb)(optparse_t* options, int line, void* userdata);
+
+/**
+ * @brief Parse every argv of an array in parallel.
+ *
+ * Each argv is parsed with optparse_init() and may be permuted by the callback's parse.
+ *
+ * @param argvs    NULL-terminated argument vectors, one per line
+ * @param count    element count of @p argvs
+ * @param threads  number of threads including the caller; 0 uses one per online CPU
+ * @param cb       callback run for each line
+ * @param userdata opaque context forwarded to @p cb
+ * @return 0 when every line was visited, the first non-zero callback result if the batch was
+ *         stopped, or -1 if memory or a lock could not be set up. A stop skips the chunks no
+ *         thread has claimed yet; other threads finish the chunk they are on, up to
+ *         OPTPARSE_BATCH_CHUNK lines each.
+ */
+OPTPARSE_API int optparse_batch_argv(char** const* argvs, int count, int threads, optparse_batch_cb cb,
+                                     void* userdata);
+
+/**
+ * @brief Parse NUL-separated argument blobs in parallel.
+ *
+ * Each blob is parsed with optparse_init_buffer(), so parsing is in order.
+ *
+ * @param blobs    arguments of each line, each followed by a NUL byte
+ * @param lens     byte count of each blob
+ * @param count    element count of @p blobs and @p lens
+ * @param threads  number of threads including the caller; 0 uses one per online CPU
+ * @param cb       callback run for each line
+ * @param userdata opaque context forwarded to @p cb
+ * @return as optparse_batch_argv()
+ */
+OPTPARSE_API int optparse_batch_blobs(char* const* blobs, const size_t* lens, int count, int threads,
+                                      optparse_batch_cb cb, void* userdata);
+
+/**
+ * @brief Run optparse_classify() over one large argv in parallel.
+ *
+ * The argv is cut into blocks of OPTPARSE_BATCH_TOKENS elements that the
+ * pool classifies independently; pass the result to optparse_classes().
+ *
+ * @param argv    NULL-terminated argument vector
+ * @param argc    element count of @p argv, not counting the NULL terminator
+ * @param classes receives argc classes
+ * @param threads number of threads including the caller; 0 uses one per online CPU
+ * @return 0, or -1 if memory or a lock could not be set up
+ */
+OPTPARSE_API int optparse_batch_classify(char* const* argv, int argc, unsigned char* classes, int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* ======================================================================
+ * IMPLEMENTATION
+ * ====================================================================== */
+#if defined(OPTPARSE_IMPLEMENTATION) && !defined(OPTPARSE_BATCH_IMPLEMENTED)
+#define OPTPARSE_BATCH_IMPLEMENTED
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OPTPARSE__CACHELINE 64
+
+struct optparse__batch;
+
+/* one per thread, each starting on its own cache line */
+struct optparse__batchworker {
+#ifdef _WIN32
+    SRWLOCK lock;
+#else
+    pthread_mutex_t lock;
+#endif
+    int                     begin;   /* unclaimed lines [begin, end), guarded by lock */
+    int                     end;
+    int                     stopped; /* set by optparse__batch_stop(), guarded by lock */
+    int                     id;
+    struct optparse__batch* batch;
+    optparse_t              options;
+    optparse_mode_t         mode;
+    char*                   window[OPTPARSE_BATCH_WINDOW];
+};
+
+struct optparse__batch {
+    char** const*     argvs;
+    char* const*      blobs;
+    const size_t*     lens;
+    char* const*      tokens;  /* optparse_batch_classify(): one line per block of tokens */
+    int               ntokens;
+    unsigned char*    classes;
+    optparse_batch_cb cb;
+    void*             userdata;
+    char*             workers; /* nworkers records of stride bytes, cache-line aligned */
+    size_t            stride;
+    int               nworkers;
+#ifdef _WIN32
+    SRWLOCK lock;
+#else
+    pthread_mutex_t lock;
+#endif
+    int result; /* first non-zero callback result, guarded by lock */
+};
+
+static struct optparse__batchworker* optparse__batch_worker(struct optparse__batch* b, int i) {
+    return (struct optparse__batchworker*)(b->workers + (size_t)i * b->stride);
+}
+
+static void optparse__batch_lock(struct optparse__batchworker* w) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&w->lock);
+#else
+    pthread_mutex_lock(&w->lock);
+#endif
+}
+
+static void optparse__batch_unlock(struct optparse__batchworker* w) {
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&w->lock);
+#else
+    pthread_mutex_unlock(&w->lock);
+#endif
+}
+
+/* claim the next chunk of our own range */
+static int optparse__batch_take(struct optparse__batchworker* w, int* lo, int* hi) {
+    optparse__batch_lock(w);
+    *lo = w->begin;
+    *hi = w->end - w->begin > OPTPARSE_BATCH_CHUNK ? w->begin + OPTPARSE_BATCH_CHUNK : w->end;
+    w->begin = *hi;
+    optparse__batch_unlock(w);
+    return *lo < *hi;
+}
+
+/* move the back half of the next non-empty range into ours; 0 when there is nothing left */
+static int optparse__batch_steal(struct optparse__batch* b, struct optparse__batchworker* self) {
+    for (int k = 1; k < b->nworkers; ++k) {
+        struct optparse__batchworker* victim = optparse__batch_worker(b, (self->id + k) % b->nworkers);
+        int                           lo, hi;
+
+        optparse__batch_lock(victim);
+        lo = victim->begin + (victim->end - victim->begin) / 2;
+        hi = victim->end;
+        if (lo < hi) { victim->end = lo; }
+        optparse__batch_unlock(victim);
+        if (lo == hi) { continue; }
+
+        optparse__batch_lock(self);
+        if (!self->stopped) {
+            self->begin = lo;
+            self->end   = hi;
+        }
+        optparse__batch_unlock(self);
+        return 1;
+    }
+    return 0;
+}
+
+/* record the result and drop every unclaimed line */
+static void optparse__batch_stop(struct optparse__batch* b, int result) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&b->lock);
+    if (b->result == 0) { b->result = result; }
+    ReleaseSRWLockExclusive(&b->lock);
+#else
+    pthread_mutex_lock(&b->lock);
+    if (b->result == 0) { b->result = result; }
+    pthread_mutex_unlock(&b->lock);
+#endif
+    for (int i = 0; i < b->nworkers; ++i) {
+        struct optparse__batchworker* w = optparse__batch_worker(b, i);
+        optparse__batch_lock(w);
+        w->begin   = w->end;
+        w->stopped = 1;
+        optparse__batch_unlock(w);
+    }
+}
+
+static void optparse__batch_work(struct optparse__batchworker* w) {
+    struct optparse__batch* b = w->batch;
+    int                     lo, hi;
+    for (;;) {
+        if (!optparse__batch_take(w, &lo, &hi)) {
+            if (!optparse__batch_steal(b, w)) { return; }
+            continue;
+        }
+        if (b->classes) {
+            const long long end = (long long)hi * OPTPARSE_BATCH_TOKENS;
+            optparse_classify(b->tokens, lo * OPTPARSE_BATCH_TOKENS, end < b->ntokens ? (int)end : b->ntokens,
+                              b->classes);
+            continue;
+        }
+        for (int line = lo; line < hi; ++line) {
+            if (b->argvs) {
+                optparse_init(&w->options, b->argvs[line]);
+            } else {
+                optparse_init_buffer(&w->options, &w->mode, w->window, OPTPARSE_BATCH_WINDOW, b->blobs[line],
+                                     b->lens[line]);
+            }
+            const int r = b->cb(&w->options, line, b->userdata);
+            if (r != 0) {
+                optparse__batch_stop(b, r);
+                return;
+            }
+        }
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI optparse__batch_thread(LPVOID arg) {
+    optparse__batch_work((struct optparse__batchworker*)arg);
+    return 0;
+}
+#else
+static void* optparse__batch_thread(void* arg) {
+    optparse__batch_work((struct optparse__batchworker*)arg);
+    return NULL;
+}
+#endif
+
+static int optparse__batch_cpus(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+#ifndef _WIN32
+/* destroy the batch lock and the locks of the first @p n workers */
+static void optparse__batch_destroy(struct optparse__batch* b, int n) {
+    for (int i = 0; i < n; ++i) { pthread_mutex_destroy(&optparse__batch_worker(b, i)->lock); }
+    pthread_mutex_destroy(&b->lock);
+}
+#endif
+
+static int optparse__batch_run(struct optparse__batch* b, int count, int threads) {
+    if (threads <= 0) { threads = optparse__batch_cpus(); }
+    if (threads > count) { threads = count; }
+    if (threads < 1) { return 0; }
+
+    b->stride   = (sizeof(struct optparse__batchworker) + OPTPARSE__CACHELINE - 1) & ~(size_t)(OPTPARSE__CACHELINE - 1);
+    b->nworkers = threads;
+    b->result   = 0;
+    char* raw   = (char*)malloc(b->stride * (size_t)threads + OPTPARSE__CACHELINE);
+#ifdef _WIN32
+    HANDLE* handles = (HANDLE*)malloc(sizeof(HANDLE) * (size_t)threads);
+#else
+    pthread_t* handles = (pthread_t*)malloc(sizeof(pthread_t) * (size_t)threads);
+#endif
+    char* started = (char*)calloc((size_t)threads, 1);
+    if (!raw || !handles || !started) {
+        free(raw);
+        free(handles);
+        free(started);
+        return -1;
+    }
+    b->workers = raw + (OPTPARSE__CACHELINE - (size_t)raw % OPTPARSE__CACHELINE) % OPTPARSE__CACHELINE;
+
+    int ready = 0; /* workers whose lock is set up */
+#ifdef _WIN32
+    InitializeSRWLock(&b->lock);
+    for (; ready < threads; ++ready) { InitializeSRWLock(&optparse__batch_worker(b, ready)->lock); }
+#else
+    if (pthread_mutex_init(&b->lock, NULL) == 0) {
+        while (ready < threads && pthread_mutex_init(&optparse__batch_worker(b, ready)->lock, NULL) == 0) { ++ready; }
+        if (ready < threads) { optparse__batch_destroy(b, ready); }
+    }
+#endif
+    if (ready < threads) {
+        free(raw);
+        free(handles);
+        free(started);
+        return -1;
+    }
+    for (int i = 0; i < threads; ++i) {
+        struct optparse__batchworker* w = optparse__batch_worker(b, i);
+        w->begin   = (int)((long long)count * i / threads);
+        w->end     = (int)((long long)count * (i + 1) / threads);
+        w->stopped = 0;
+        w->id      = i;
+        w->batch   = b;
+    }
+
+    /* a thread that fails to start leaves its range to be stolen by the others */
+    for (int i = 1; i < threads; ++i) {
+#ifdef _WIN32
+        handles[i] = CreateThread(NULL, 0, optparse__batch_thread, optparse__batch_worker(b, i), 0, NULL);
+        started[i] = handles[i] != NULL;
+#else
+        started[i] = pthread_create(&handles[i], NULL, optparse__batch_thread, optparse__batch_worker(b, i)) == 0;
+#endif
+    }
+    optparse__batch_work(optparse__batch_worker(b, 0));
+    for (int i = 1; i < threads; ++i) {
+        if (!started[i]) { continue; }
+#ifdef _WIN32
+        WaitForSingleObject(handles[i], INFINITE);
+        CloseHandle(handles[i]);
+#else
+        pthread_join(handles[i], NULL);
+#endif
+    }
+
+#ifndef _WIN32
+    optparse__batch_destroy(b, threads);
+#endif
+    free(raw);
+    free(handles);
+    free(started);
+    return b->result;
+}
+
+OPTPARSE_API int optparse_batch_argv(char** const* argvs, int count, int threads, optparse_batch_cb cb,
+                                     void* userdata) {
+    struct optparse__batch b;
+    b.argvs    = argvs;
+    b.blobs    = NULL;
+    b.lens     = NULL;
+    b.classes  = NULL;
+    b.cb       = cb;
+    b.userdata = userdata;
+    return optparse__batch_run(&b, count, threads);
+}
+
+OPTPARSE_API int optparse_batch_blobs(char* const* blobs, const size_t* lens, int count, int threads,
+                                      optparse_batch_cb cb, void* userdata) {
+    struct optparse__batch b;
+    b.argvs    = NULL;
+    b.blobs    = blobs;
+    b.lens     = lens;
+    b.classes  = NULL;
+    b.cb       = cb;
+    b.userdata = userdata;
+    return optparse__batch_run(&b, count, threads);
+}
+
+OPTPARSE_API int optparse_batch_classify(char* const* argv, int argc, unsigned char* classes, int threads) {
+    struct optparse__batch b;
+    b.argvs   = NULL;
+    b.blobs   = NULL;
+    b.lens    = NULL;
+    b.tokens  = argv;
+    b.ntokens = argc;
+    b.classes = classes;
+    b.cb      = NULL;
+    const int r = optparse__batch_run(&b, (int)(((long long)argc + OPTPARSE_BATCH_TOKENS - 1) / OPTPARSE_BATCH_TOKENS),
+                                      threads);
+    return r < 0 ? -1 : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // OPTPARSE_IMPLEMENTATION
+#endif  // OPTPARSE_BATCH_H
@@ -0,0 +1,362 @@
+/**
+ * @file memo.h
+ * @brief Memoized parsing of repeated command lines for optparse.
+ *
+ * Servers often see the same command line byte for byte again and again.
+ * optparse_memo_parse() hashes the arguments (FNV-1a) together with the
+ * identity of the option table and, on a hit, replays the events recorded
+ * the first time instead of parsing again; the optarg pointers are rebased
+ * onto the new argv. Entries are kept in least-recently-used order up to a
+ * fixed count.
+ *
+ * Parsing follows optparse_long_all() in record mode (optparse_record()):
+ * argv is never written, non-options are reported as argv indices, and the
+ * events stop after the first error. argv[0] is not part of the key.
+ *
+ * A memo is not thread-safe; give each thread its own. Unlike optparse.h this
+ * module allocates. Include it after defining OPTPARSE_IMPLEMENTATION in the
+ * same source file that implements optparse.h.
+ *
+ * This is free and unencumbered software released into the public domain.
+ */
+#ifndef OPTPARSE_MEMO_H
+#define OPTPARSE_MEMO_H
+
+#include <stddef.h>
+
+#include "optparse.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct optparse_memo optparse_memo_t;
+
+/**
+ * @brief Outcome of optparse_memo_parse(); valid until the next call on the same memo.
+ */
+typedef struct optparse_memo_result {
+    const optparse_event_t* events;      /* what optparse_long_all() would have written */
+    int                     count;       /* element count of events */
+    const int*              positionals; /* argv indices of the non-options, in order */
+    int                     npos;        /* element count of positionals */
+    const char*             errmsg;      /* message of a trailing '?' event, else "" */
+    int                     hit;         /* non-zero if replayed from the memo */
+} optparse_memo_result_t;
+
+/**
+ * @brief Create a memo.
+ * @param max_entries number of distinct command lines kept; 0 disables storing
+ * @return new memo, or NULL if memory could not be allocated
+ */
+OPTPARSE_API optparse_memo_t* optparse_memo_new(int max_entries);
+
+/**
+ * @brief Destroy a memo and everything it stores.
+ * @param memo memo created by optparse_memo_new(), or NULL
+ */
+OPTPARSE_API void optparse_memo_free(optparse_memo_t* memo);
+
+/**
+ * @brief Parse @p argv against @p longopts, replaying a stored result when possible.
+ *
+ * The key is the argument bytes and the @p longopts pointer: a table must not
+ * be modified while the memo may hold results for it.
+ *
+ * @param memo     memo to consult and update
+ * @param argv     NULL-terminated argument vector; not modified
+ * @param longopts long option descriptor array, terminated with {0, 0, OPTPARSE_NONE, NULL}
+ * @param result   receives the events and positionals
+ * @return 0, or -1 if memory could not be allocated
+ */
+OPTPARSE_API int optparse_memo_parse(optparse_memo_t* memo, char** argv, const optparse_long_t* longopts,
+                                     optparse_memo_result_t* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* ======================================================================
+ * IMPLEMENTATION
+ * ====================================================================== */
+#if defined(OPTPARSE_IMPLEMENTATION) && !defined(OPTPARSE_MEMO_IMPLEMENTED)
+#define OPTPARSE_MEMO_IMPLEMENTED
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* an event with optarg stored as a position, so it can be rebased onto another argv */
+struct optparse__memoev {
+    int option;
+    int longindex;
+    int argind;
+    int optind; /* argv index holding optarg, -1 if optarg is NULL */
+    int optoff; /* byte offset of optarg in that element */
+};
+
+struct optparse__memoent {
+    struct optparse__memoent* prev; /* LRU list, most recent first */
+    struct optparse__memoent* next;
+    struct optparse__memoent* chain; /* hash bucket */
+    unsigned long long        hash;
+    const optparse_long_t*    longopts;
+    int                       argc;
+    size_t                    textlen; /* argv[1..] bytes including their NULs */
+    int                       count;
+    int                       npos;
+    char                      errmsg[64];
+    /* followed by: events[count], positionals[npos], text[textlen] */
+};
+
+struct optparse_memo {
+    struct optparse__memoent** buckets;
+    size_t                     mask;
+    struct optparse__memoent*  head;
+    struct optparse__memoent*  tail;
+    int                        entries;
+    int                        max_entries;
+
+    /* scratch reused by every call; results point here */
+    optparse_event_t* events;
+    int               evcap;
+    int*              pos;
+    int               poscap;
+    char              errmsg[64]; /* message of an unstored result */
+};
+
+OPTPARSE_API optparse_memo_t* optparse_memo_new(int max_entries) {
+    optparse_memo_t* memo = (optparse_memo_t*)calloc(1, sizeof(*memo));
+    size_t           n    = 16;
+    if (!memo) { return NULL; }
+    while ((int)(n / 2) < max_entries) { n *= 2; }
+    if (!(memo->buckets = (struct optparse__memoent**)calloc(n, sizeof(*memo->buckets)))) {
+        free(memo);
+        return NULL;
+    }
+    memo->mask        = n - 1;
+    memo->max_entries = max_entries < 0 ? 0 : max_entries;
+    return memo;
+}
+
+OPTPARSE_API void optparse_memo_free(optparse_memo_t* memo) {
+    if (!memo) { return; }
+    while (memo->head) {
+        struct optparse__memoent* next = memo->head->next;
+        free(memo->head);
+        memo->head = next;
+    }
+    free(memo->buckets);
+    free(memo->events);
+    free(memo->pos);
+    free(memo);
+}
+
+static struct optparse__memoev* optparse__memo_events(struct optparse__memoent* e) {
+    return (struct optparse__memoev*)(e + 1);
+}
+
+static int* optparse__memo_positionals(struct optparse__memoent* e) {
+    return (int*)(optparse__memo_events(e) + e->count);
+}
+
+static char* optparse__memo_text(struct optparse__memoent* e) {
+    return (char*)(optparse__memo_positionals(e) + e->npos);
+}
+
+static int optparse__memo_reserve(optparse_memo_t* memo, int events, int positionals) {
+    if (events > memo->evcap) {
+        optparse_event_t* ev = (optparse_event_t*)realloc(memo->events, (size_t)events * sizeof(*ev));
+        if (!ev) { return -1; }
+        memo->events = ev;
+        memo->evcap  = events;
+    }
+    if (positionals > memo->poscap) {
+        int* pos = (int*)realloc(memo->pos, (size_t)positionals * sizeof(*pos));
+        if (!pos) { return -1; }
+        memo->pos    = pos;
+        memo->poscap = positionals;
+    }
+    return 0;
+}
+
+static void optparse__memo_unlink(optparse_memo_t* memo, struct optparse__memoent* e) {
+    if (e->prev) {
+        e->prev->next = e->next;
+    } else {
+        memo->head = e->next;
+    }
+    if (e->next) {
+        e->next->prev = e->prev;
+    } else {
+        memo->tail = e->prev;
+    }
+}
+
+static void optparse__memo_push_front(optparse_memo_t* memo, struct optparse__memoent* e) {
+    e->prev = NULL;
+    e->next = memo->head;
+    if (memo->head) {
+        memo->head->prev = e;
+    } else {
+        memo->tail = e;
+    }
+    memo->head = e;
+}
+
+static void optparse__memo_evict(optparse_memo_t* memo) {
+    struct optparse__memoent*  e    = memo->tail;
+    struct optparse__memoent** link = &memo->buckets[e->hash & memo->mask];
+    while (*link != e) { link = &(*link)->chain; }
+    *link = e->chain;
+    optparse__memo_unlink(memo, e);
+    free(e);
+    --memo->entries;
+}
+
+/* does the stored text equal argv[1..argc)? */
+static int optparse__memo_same(struct optparse__memoent* e, char** argv) {
+    const char* t = optparse__memo_text(e);
+    for (int i = 1; i < e->argc; ++i) {
+        const char* a = argv[i];
+        while (*a && *a == *t) { ++a, ++t; }
+        if (*a != *t) { return 0; }
+        ++t;
+    }
+    return 1;
+}
+
+/* parse for real into the scratch arrays; returns 1 if it stopped at an error, -1 on allocation failure */
+static int optparse__memo_run(optparse_memo_t* memo, char** argv, int argc, const optparse_long_t* longopts,
+                              optparse_memo_result_t* result, char* errmsg) {
+    optparse_t      options;
+    optparse_mode_t mode;
+    int             n = 0;
+
+    if (optparse__memo_reserve(memo, 16, argc) != 0) { return -1; }
+    optparse_init(&options, argv);
+    optparse_record(&options, &mode, memo->pos, argc);
+    for (;;) {
+        n += optparse_long_all(&options, longopts, memo->events + n, memo->evcap - n);
+        if (n < memo->evcap || memo->events[n - 1].option == '?') { break; }
+        if (optparse__memo_reserve(memo, memo->evcap * 2, argc) != 0) { return -1; }
+    }
+
+    const int failed    = n > 0 && memo->events[n - 1].option == '?';
+    result->events      = memo->events;
+    result->count       = n;
+    result->positionals = memo->pos;
+    result->npos        = mode.posc;
+    result->hit         = 0;
+    /* elements left after "--" follow the recorded ones, as optparse_arg() would return them */
+    if (!failed) {
+        for (int i = options.optind; i < argc; ++i) { memo->pos[result->npos++] = i; }
+    }
+    memcpy(errmsg, failed ? options.errmsg : "", failed ? sizeof(options.errmsg) : 1);
+    return failed;
+}
+
+OPTPARSE_API int optparse_memo_parse(optparse_memo_t* memo, char** argv, const optparse_long_t* longopts,
+                                     optparse_memo_result_t* result) {
+    /* FNV-1a over the table identity and every argument with its terminator */
+    unsigned long long hash    = 14695981039346656037ull;
+    size_t             textlen = 0;
+    int                argc    = argv[0] ? 1 : 0;
+    const size_t       table   = (size_t)longopts;
+    for (size_t k = 0; k < sizeof(table); ++k) { hash = (hash ^ ((table >> (8 * k)) & 0xff)) * 1099511628211ull; }
+    for (; argc > 0 && argv[argc]; ++argc) {
+        const unsigned char* a = (const unsigned char*)argv[argc];
+        do { hash = (hash ^ *a) * 1099511628211ull; } while (*a++);
+        textlen += (size_t)((const char*)a - argv[argc]);
+    }
+
+    struct optparse__memoent* e = memo->buckets[hash & memo->mask];
+    for (; e; e = e->chain) {
+        if (e->hash == hash && e->longopts == longopts && e->argc == argc && e->textlen == textlen &&
+            optparse__memo_same(e, argv)) {
+            break;
+        }
+    }
+
+    if (e) {
+        const struct optparse__memoev* ev = optparse__memo_events(e);
+        if (optparse__memo_reserve(memo, e->count, e->npos) != 0) { return -1; }
+        for (int k = 0; k < e->count; ++k) {
+            memo->events[k].option    = ev[k].option;
+            memo->events[k].longindex = ev[k].longindex;
+            memo->events[k].argind    = ev[k].argind;
+            memo->events[k].optarg    = ev[k].optind < 0 ? NULL : argv[ev[k].optind] + ev[k].optoff;
+        }
+        memcpy(memo->pos, optparse__memo_positionals(e), (size_t)e->npos * sizeof(int));
+        result->events      = memo->events;
+        result->count       = e->count;
+        result->positionals = memo->pos;
+        result->npos        = e->npos;
+        result->errmsg      = e->errmsg;
+        result->hit         = 1;
+        optparse__memo_unlink(memo, e);
+        optparse__memo_push_front(memo, e);
+        return 0;
+    }
+
+    char      errmsg[64];
+    const int failed = optparse__memo_run(memo, argv, argc, longopts, result, errmsg);
+    if (failed < 0) { return -1; }
+
+    const size_t size = sizeof(*e) + (size_t)result->count * sizeof(struct optparse__memoev) +
+                        (size_t)result->npos * sizeof(int) + textlen;
+    if (memo->max_entries == 0 || !(e = (struct optparse__memoent*)malloc(size))) {
+        /* an unstored result is still a correct one; the scratch memo keeps the message alive */
+        memcpy(memo->errmsg, errmsg, sizeof(errmsg));
+        result->errmsg = memo->errmsg;
+        return 0;
+    }
+    e->hash     = hash;
+    e->longopts = longopts;
+    e->argc     = argc;
+    e->textlen  = textlen;
+    e->count    = result->count;
+    e->npos     = result->npos;
+    memcpy(e->errmsg, errmsg, sizeof(errmsg));
+    result->errmsg = e->errmsg;
+
+    struct optparse__memoev* ev = optparse__memo_events(e);
+    for (int k = 0; k < e->count; ++k) {
+        const optparse_event_t* src = &memo->events[k];
+        const int               i   = src->argind;
+        ev[k].option                = src->option;
+        ev[k].longindex             = src->longindex;
+        ev[k].argind                = i;
+        ev[k].optind                = -1;
+        ev[k].optoff                = 0;
+        if (src->optarg) {
+            /* optarg is either the next element ("-d 5") or inside this one ("--delay=5", "-d5") */
+            ev[k].optind = i + 1 < argc && src->optarg == argv[i + 1] ? i + 1 : i;
+            ev[k].optoff = (int)(src->optarg - argv[ev[k].optind]);
+        }
+    }
+    memcpy(optparse__memo_positionals(e), memo->pos, (size_t)e->npos * sizeof(int));
+    char* t = optparse__memo_text(e);
+    for (int i = 1; i < argc; ++i) {
+        const size_t len = strlen(argv[i]) + 1;
+        memcpy(t, argv[i], len);
+        t += len;
+    }
+
+    if (memo->entries == memo->max_entries) { optparse__memo_evict(memo); }
+    struct optparse__memoent** bucket = &memo->buckets[hash & memo->mask];
+    e->chain                          = *bucket;
+    *bucket                           = e;
+    optparse__memo_push_front(memo, e);
+    ++memo->entries;
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // OPTPARSE_IMPLEMENTATION
+#endif  // OPTPARSE_MEMO_H
@@ -24,6 +24,8 @@
 #ifndef OPTPARSE_OPTPARSE_H
 #define OPTPARSE_OPTPARSE_H
 
+#include <stddef.h> /* size_t, NULL: freestanding, no libc needed */
+
 #ifndef OPTPARSE_API
 #define OPTPARSE_API
 #endif
@@ -32,6 +34,37 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Argument source for optparse_init_stream().
+ * @param userdata opaque context passed to optparse_init_stream()
+ * @return next argument, or NULL at the end of the stream
+ */
+typedef char* (*optparse_source_cb)(void* userdata);
+
+/**
+ * @brief Caller storage for the state of the optional parse modes.
+ *
+ * optparse_t only points to it, so a plain optparse_init() parser carries
+ * none of this. Each function that switches a mode on takes one as its
+ * second argument and attaches it unless the parser already has one, which
+ * it then uses instead; it must outlive the parse. All fields are internal.
+ */
+typedef struct optparse_mode {
+    int*                 posv;     /* recorded non-option indices, NULL unless optparse_record() */
+    int                  poscap;   /* capacity of posv */
+    int                  posc;     /* recorded entries in posv */
+    int                  posnext;  /* next posv entry returned by optparse_arg() */
+    optparse_source_cb   source;   /* stream source, NULL once exhausted or unless optparse_init_stream() */
+    void*                srcdata;  /* userdata for source */
+    int                  wincap;   /* capacity of the stream window in argv, 0 for a plain argv */
+    char*                bufnext;  /* next argument in the optparse_init_buffer() blob */
+    char*                bufend;   /* end of that blob */
+    const unsigned char* classes;  /* token classes from optparse_classes(), NULL if unused */
+    int                  nclasses; /* element count of classes */
+    int                  argc;     /* element count of argv, -1 when NULL-terminated */
+    const size_t*        lengths;  /* byte count of each argv element, NULL if unknown */
+} optparse_mode_t;
+
 /**
  * @brief Core parser state.
  *
@@ -39,22 +72,102 @@ extern "C" {
  *   optind  – index of next argv element
  *   optopt  – the option character just parsed
  *   optarg  – argument for current option (may be NULL)
+ *   optarglen – byte count of optarg, -1 unless optparse_init_lengths() was used
  *   errmsg  – error string (non-empty only when '?' returned)
  *
  * Caller may set before/between calls:
  *   permute – non-zero (default) to permute non-options to end;
- *             set 0 to stop at first non-option (POSIX mode)
+ *             set 0 to stop at first non-option (POSIX mode);
+ *             see optparse_order_t for the named values
+ *
+ * Scanning resumes where the previous call stopped (argv[optind + nonopts]),
+ * so each element is classified once per parse. Permutation is stable and
+ * mostly deferred: skipped non-options are moved behind the consumed options
+ * in blocks, so a full parse costs O(argc) pointer moves when options and
+ * non-options come in runs, and O(argc * sqrt(argc)) when they alternate.
+ * See optparse_record() for a mode that never writes argv.
  */
 typedef struct optparse {
-    char   errmsg[64];
-    char*  optarg;
-    char** argv;
-    int    permute;
-    int    optind;
-    int    optopt;
-    int    subopt; /* internal: offset within short-opt cluster */
+    char             errmsg[64];
+    char*            optarg;
+    ptrdiff_t        optarglen; /* byte count of optarg, -1 unless token lengths are known */
+    char**           argv;
+    int              permute;
+    int              optind;
+    int              optopt;
+    int              subopt;    /* internal: offset within short-opt cluster */
+    int              nonopts;   /* internal: skipped non-options awaiting permutation */
+    int              parked;    /* internal: consumed elements parked behind those non-options */
+    const char*      errwhat;   /* internal: message of the last error */
+    const char*      errdata;   /* internal: its subject, in argv or the option table */
+    int              errlen;    /* internal: byte count of errdata */
+    const void*      errcands;  /* internal: optparse_index_t holding an ambiguous option's candidates */
+    optparse_mode_t* mode;      /* internal: optional-mode state, NULL for a plain optparse_init() parser */
 } optparse_t;
 
+/**
+ * @brief Named values for optparse_t::permute.
+ *
+ * OPTPARSE_RETURN_IN_ORDER mirrors GNU getopt's leading '-': each non-option
+ * is returned where it appears as option 1 with optarg pointing at it, so
+ * argument order is kept in a single forward pass that never writes argv.
+ */
+typedef enum optparse_order {
+    OPTPARSE_REQUIRE_ORDER   = 0, /* stop at first non-option (POSIX mode) */
+    OPTPARSE_PERMUTE         = 1, /* permute non-options to the end (default) */
+    OPTPARSE_RETURN_IN_ORDER = 2, /* return non-options in place as option 1 */
+} optparse_order_t;
+
+/**
+ * @brief One result recorded by optparse_long_all().
+ *
+ * @c argind is the argv index of the element that produced the event at parse
+ * time; it stays valid afterwards unless argv is permuted (see optparse_record()).
+ */
+typedef struct optparse_event {
+    int   option;    /* what optparse_long() would return: shortname, 1 or '?' */
+    int   longindex; /* index into longopts, or -1 */
+    int   argind;    /* argv index of the option element */
+    char* optarg;    /* option argument, may be NULL */
+} optparse_event_t;
+
+/**
+ * @brief Lexical class of an argv element, as stored by optparse_classify().
+ *
+ * The class depends on the element alone, not on its neighbours: an element
+ * that turns out to be the argument of a preceding option keeps its own class
+ * and the parser simply never looks it up.
+ */
+typedef enum optparse_class {
+    OPTPARSE_CLASS_POSITIONAL = 0, /* no leading dash, or "-" on its own */
+    OPTPARSE_CLASS_SHORT      = 1, /* "-x..." */
+    OPTPARSE_CLASS_LONG       = 2, /* "--name..." */
+    OPTPARSE_CLASS_DASHDASH   = 3, /* "--" */
+} optparse_class_t;
+
+/**
+ * @brief Results of optparse_long_id() other than an option's descriptor index.
+ *
+ * All of them are negative, so any result >= 0 indexes the descriptor array.
+ */
+typedef enum optparse_id {
+    OPTPARSE_ID_DONE       = -1, /* no more options, as optparse_long() returns -1 */
+    OPTPARSE_ID_ERROR      = -2, /* as optparse_long() returns '?'; errmsg says why */
+    OPTPARSE_ID_POSITIONAL = -3, /* a non-option in OPTPARSE_RETURN_IN_ORDER mode, in optarg */
+} optparse_id_t;
+
+/**
+ * @brief What optparse_long_bind() does with an option, and the type of optparse_bind_t::dest.
+ */
+typedef enum optparse_action {
+    OPTPARSE_BIND_NONE   = 0, /* no binding: optparse_long_bind() returns the option's index */
+    OPTPARSE_BIND_STRING = 1, /* char**: set to optarg, NULL for an absent optional argument */
+    OPTPARSE_BIND_FLAG   = 2, /* int*: set to 1 */
+    OPTPARSE_BIND_COUNT  = 3, /* int*: incremented */
+    OPTPARSE_BIND_APPEND = 4, /* optparse_list_t*: optarg appended in the arena, unless absent */
+    OPTPARSE_BIND_INT    = 5, /* long*: optarg as a decimal integer, unless absent */
+} optparse_action_t;
+
 typedef enum optparse_argtype {
     OPTPARSE_NONE     = 0,
     OPTPARSE_REQUIRED = 1,
@@ -75,6 +188,79 @@ typedef struct optparse_long {
     const char*        argname; /* placeholder name, default "ARG" */
 } optparse_long_t;
 
+/**
+ * @brief Binding for the optparse_long_t at the same index, used by optparse_long_bind().
+ *
+ * A zero-initialized entry binds nothing, so a binding array can list just
+ * the options it stores, e.g. with designated initializers.
+ */
+typedef struct optparse_bind {
+    optparse_action_t action;
+    void*             dest; /* type depends on action */
+} optparse_bind_t;
+
+/**
+ * @brief Compiled short-option table, built once by optparse_compile_short().
+ *
+ * Maps every byte to its optparse_argtype_t, or -1 if it is not an option,
+ * so each option character costs one table load instead of an optstring scan.
+ */
+typedef struct optparse_shortopts {
+    signed char argtype[256];
+} optparse_shortopts_t;
+
+/**
+ * @brief Lookup index over an optparse_long_t array, built once by optparse_index_init().
+ *
+ * Long names are resolved by binary search over @c order and short options by
+ * a direct byte table, so a lookup no longer walks the whole descriptor array.
+ * The index only refers to the descriptors; keep them alive and unmodified.
+ */
+typedef struct optparse_index {
+    const optparse_long_t* longopts;
+    int*                   order;         /* caller storage: named entries sorted by longname */
+    int                    count;         /* number of entries in order */
+    int                    shortidx[256]; /* first entry per short option byte, -1 if none */
+} optparse_index_t;
+
+/**
+ * @brief Caller-supplied long-name resolver, e.g. a table generated at compile time (see optparse.hpp).
+ *
+ * @c find receives the option text after "--", which ends at '=' or NUL, and
+ * returns the index of the matching descriptor or -1. Short option bytes are
+ * resolved through @c shortidx exactly as in optparse_index_t.
+ */
+typedef struct optparse_lookup {
+    const optparse_long_t* longopts;
+    int (*find)(const void* table, const char* option);
+    const void* table;    /* passed back to find */
+    const int*  shortidx; /* 256 entries: first entry per short option byte, -1 if none */
+} optparse_lookup_t;
+
+/**
+ * @brief First 16 bytes of one long name, NUL padded; one row per descriptor of an optparse_packed_t.
+ */
+typedef struct optparse_packed_row {
+    size_t head[16 / sizeof(size_t)];
+} optparse_packed_row_t;
+
+/**
+ * @brief Packed-prefix matcher over an optparse_long_t array, built once by optparse_packed_init().
+ *
+ * The leading bytes of every long name sit in one contiguous array, so
+ * "--name" is matched by comparing its first 16 bytes against each row in
+ * turn (16 at once with SSE2, a word at a time otherwise) with no per-byte
+ * branches. Only a row whose prefix matches is compared in full. Suits
+ * tables of a few dozen to a few hundred options; keep the descriptors
+ * alive and unmodified.
+ */
+typedef struct optparse_packed {
+    const optparse_long_t* longopts;
+    optparse_packed_row_t* rows;          /* caller storage: one row per descriptor, in descriptor order */
+    int                    count;         /* number of rows */
+    int                    shortidx[256]; /* first entry per short option byte, -1 if none */
+} optparse_packed_t;
+
 /**
  * @brief Initialize parser state; must be called before any parse call.
  * @param options parser state to initialize
@@ -82,6 +268,134 @@ typedef struct optparse_long {
  */
 OPTPARSE_API void optparse_init(optparse_t* options, char** argv);
 
+/**
+ * @brief Initialize parser state over a counted argv with known element lengths.
+ *
+ * argv needs no NULL terminator, so a sub-range of a larger array can be
+ * parsed in place; elements must still be NUL-terminated. With @p lengths,
+ * optarglen is set for every option argument from the element length, so
+ * a value is never scanned to find its end, however large.
+ *
+ * @param options parser state to initialize
+ * @param mode    caller storage for the mode state
+ * @param argv    argument vector; argv[0] is skipped
+ * @param argc    element count of @p argv
+ * @param lengths byte count of each element, e.g. from optparse_prescan(); may be NULL
+ */
+OPTPARSE_API void optparse_init_lengths(optparse_t* options, optparse_mode_t* mode, char** argv, int argc,
+                                        const size_t* lengths);
+
+/**
+ * @brief Initialize parser state over an argument stream instead of an argv array.
+ *
+ * Arguments are pulled from @p source on demand into @p window, which then
+ * serves as argv: consumed elements are dropped and the window is topped up
+ * so that the current element and the one after it are always present, which
+ * is all an option with a required argument needs. Memory stays bounded by
+ * @p capacity however long the stream is.
+ *
+ * Every returned string must stay valid while it is in the window: a source
+ * may reuse its storage once it has returned capacity - 1 newer arguments.
+ * optind is relative to the window. Parsing is in order: non-options are
+ * returned as option 1 (OPTPARSE_RETURN_IN_ORDER, the default here, and also
+ * used for OPTPARSE_PERMUTE, which would have to buffer the whole stream) or
+ * stop the parse (OPTPARSE_REQUIRE_ORDER). optparse_arg() pulls the remaining
+ * arguments after -1. optparse_record() does not apply.
+ *
+ * @param options  parser state to initialize
+ * @param mode     caller storage for the mode state
+ * @param window   caller storage for the window; there is no program name
+ * @param capacity element count of @p window, at least 4
+ * @param source   callback producing the next argument
+ * @param userdata opaque context forwarded to @p source
+ */
+OPTPARSE_API void optparse_init_stream(optparse_t* options, optparse_mode_t* mode, char** window, int capacity,
+                                       optparse_source_cb source, void* userdata);
+
+/**
+ * @brief Initialize parser state over a blob of NUL-terminated arguments.
+ *
+ * Parses the format of /proc/<pid>/cmdline, `find -print0` and `xargs -0`
+ * directly: arguments are located lazily, a word at a time, as the stream
+ * window of optparse_init_stream() asks for them, and point into @p buf. The
+ * first argument is the program name and ends up in window[0], as argv[0]
+ * would. A trailing fragment without a NUL is ignored. All stream-mode rules
+ * apply: parsing is in order and optind is relative to the window.
+ *
+ * @param options  parser state to initialize
+ * @param mode     caller storage for the mode state
+ * @param window   caller storage for the window
+ * @param capacity element count of @p window, at least 4
+ * @param buf      arguments, each followed by a NUL byte
+ * @param len      byte count of @p buf
+ */
+OPTPARSE_API void optparse_init_buffer(optparse_t* options, optparse_mode_t* mode, char** window, int capacity,
+                                       char* buf, size_t len);
+
+/**
+ * @brief Switch to non-mutating mode; call after optparse_init(), before parsing.
+ *
+ * argv is never written. Non-options skipped while permuting are recorded as
+ * argv indices in @p positions and optparse_arg() returns them, in order,
+ * before any elements left after "--" or a POSIX-mode stop. optind then
+ * tracks the scan position instead of the consumed-option count.
+ *
+ * When @p positions is full, the next non-option fails with '?' and stays
+ * at argv[optind]; drain the recorded ones with optparse_arg() to continue.
+ *
+ * @param options   parser state
+ * @param mode      caller storage for the mode state
+ * @param positions caller storage for non-option indices
+ * @param capacity  element count of @p positions
+ */
+OPTPARSE_API void optparse_record(optparse_t* options, optparse_mode_t* mode, int* positions, int capacity);
+
+/**
+ * @brief Classify argv[begin..end) into one optparse_class_t byte per element.
+ *
+ * Each element is classified on its own, so disjoint ranges of one argv may
+ * be classified concurrently from several threads (see optparse/batch.h).
+ *
+ * @param argv    argument vector
+ * @param begin   first index to classify
+ * @param end     one past the last index; every element in the range must be non-NULL
+ * @param classes receives the class of argv[i] in classes[i]
+ */
+OPTPARSE_API void optparse_classify(char* const* argv, int begin, int end, unsigned char* classes);
+
+/**
+ * @brief Classify and measure argv[begin..end) in one linear pass.
+ *
+ * Like optparse_classify(), and also stores each element's length. The
+ * strings of an argv are scattered over the heap, so the scan prefetches
+ * the string a few elements ahead of the one it is reading; on a cold argv
+ * the misses overlap instead of being taken one at a time.
+ *
+ * @param argv    argument vector
+ * @param begin   first index to scan
+ * @param end     one past the last index; every element in the range must be non-NULL
+ * @param classes receives the class of argv[i] in classes[i]
+ * @param lengths receives strlen(argv[i]) in lengths[i]; may be NULL
+ */
+OPTPARSE_API void optparse_prescan(char* const* argv, int begin, int end, unsigned char* classes, size_t* lengths);
+
+/**
+ * @brief Let the parser read token classes from @p classes instead of the argv strings.
+ *
+ * Call after optparse_init() and before parsing. The scan then only touches
+ * the strings of elements that are options or option arguments. Indices at
+ * or beyond @p count are classified on the fly. Permutation invalidates the
+ * array, so it is dropped once non-options have been moved. Ignored for
+ * optparse_init_stream() and optparse_init_buffer() parsers.
+ *
+ * @param options parser state
+ * @param mode    caller storage for the mode state
+ * @param classes classes of argv[0..count), filled by optparse_classify() or optparse_prescan(); must outlive the parse
+ * @param count   element count of @p classes
+ */
+OPTPARSE_API void optparse_classes(optparse_t* options, optparse_mode_t* mode, const unsigned char* classes,
+                                   int count);
+
 /**
  * @brief Parse next short option.
  * @param options   parser state
@@ -90,6 +404,21 @@ OPTPARSE_API void optparse_init(optparse_t* options, char** argv);
  */
 OPTPARSE_API int optparse(optparse_t* options, const char* optstring);
 
+/**
+ * @brief Compile a getopt()-style option string into a lookup table.
+ * @param table     table to fill
+ * @param optstring option string in the same format accepted by optparse()
+ */
+OPTPARSE_API void optparse_compile_short(optparse_shortopts_t* table, const char* optstring);
+
+/**
+ * @brief Parse next short option using a compiled table; behaves exactly like optparse().
+ * @param options parser state
+ * @param table   table filled by optparse_compile_short()
+ * @return option character, -1 when done, '?' on error
+ */
+OPTPARSE_API int optparse_short(optparse_t* options, const optparse_shortopts_t* table);
+
 /**
  * @brief Parse next option, supporting both short and GNU-style long options.
  * @param options   parser state
@@ -99,6 +428,103 @@ OPTPARSE_API int optparse(optparse_t* options, const char* optstring);
  */
 OPTPARSE_API int optparse_long(optparse_t* options, const optparse_long_t* longopts, int* longindex);
 
+/**
+ * @brief Parse all remaining options in one call into a flat event array.
+ *
+ * Equivalent to calling optparse_long() until it returns -1, recording each
+ * result. Non-options follow the parser mode: permuted to argv[optind..],
+ * recorded with optparse_record(), or returned as events with option 1 in
+ * OPTPARSE_RETURN_IN_ORDER mode. Parsing stops after the first '?' event,
+ * which is then the last one written and leaves errmsg set.
+ *
+ * @param options  parser state
+ * @param longopts long option descriptor array, terminated with {0, 0, OPTPARSE_NONE, NULL}
+ * @param events   caller storage for the results
+ * @param capacity element count of @p events
+ * @return number of events written; if it equals @p capacity, call again to continue
+ */
+OPTPARSE_API int optparse_long_all(optparse_t* options, const optparse_long_t* longopts, optparse_event_t* events,
+                                   int capacity);
+
+/**
+ * @brief Parse next option like optparse_long(), but return the index of its descriptor.
+ *
+ * Short and long spellings of an option both return the same dense index, so
+ * results can index flat arrays or bitsets sized by the descriptor count, and
+ * long-only options need no made-up shortname (0 will do).
+ *
+ * @param options  parser state
+ * @param longopts long option descriptor array, terminated with {0, 0, OPTPARSE_NONE, NULL}
+ * @return index into longopts, or an optparse_id_t: OPTPARSE_ID_DONE, OPTPARSE_ID_ERROR, OPTPARSE_ID_POSITIONAL
+ */
+OPTPARSE_API int optparse_long_id(optparse_t* options, const optparse_long_t* longopts);
+
+/**
+ * @brief Build a lookup index over a long option array.
+ * @param index    index to fill
+ * @param longopts long option descriptor array, terminated with {0, 0, OPTPARSE_NONE, NULL}
+ * @param order    caller storage for the sorted name order, one int per named entry
+ * @param capacity element count of @p order
+ * @return number of long names indexed, or -1 if @p capacity is too small
+ */
+OPTPARSE_API int optparse_index_init(optparse_index_t* index, const optparse_long_t* longopts, int* order,
+                                     int capacity);
+
+/**
+ * @brief Parse next option using a prebuilt index; behaves exactly like optparse_long().
+ * @param options   parser state
+ * @param index     index filled by optparse_index_init()
+ * @param longindex receives index into the indexed longopts, or -1 for short options
+ * @return option character / shortname, -1 when done, '?' on error
+ */
+OPTPARSE_API int optparse_long_indexed(optparse_t* options, const optparse_index_t* index, int* longindex);
+
+/**
+ * @brief Like optparse_long_indexed(), but also accept unambiguous abbreviations of long names.
+ *
+ * "--verb" selects "--verbose" when no other long name starts with "verb".
+ * An exact name always wins, and a prefix shared only by aliases (entries
+ * with the same non-zero shortname and argtype) selects the first of them.
+ * Otherwise '?' is returned and errmsg lists the candidates, as in
+ * "ambiguous option -- 'ver' (verbose, version)". The candidates form one
+ * run of the sorted index, so a lookup is a binary search plus that run.
+ *
+ * @param options   parser state
+ * @param index     index filled by optparse_index_init()
+ * @param longindex receives index into the indexed longopts, or -1 for short options
+ * @return option character / shortname, -1 when done, '?' on error
+ */
+OPTPARSE_API int optparse_long_abbrev(optparse_t* options, const optparse_index_t* index, int* longindex);
+
+/**
+ * @brief Parse next option using a caller-supplied resolver; behaves exactly like optparse_long().
+ * @param options   parser state
+ * @param lookup    resolver over its longopts
+ * @param longindex receives index into the resolved longopts, or -1 for short options
+ * @return option character / shortname, -1 when done, '?' on error
+ */
+OPTPARSE_API int optparse_long_lookup(optparse_t* options, const optparse_lookup_t* lookup, int* longindex);
+
+/**
+ * @brief Build a packed-prefix matcher over a long option array.
+ * @param packed   matcher to fill
+ * @param longopts long option descriptor array, terminated with {0, 0, OPTPARSE_NONE, NULL}
+ * @param rows     caller storage for the name prefixes, one row per descriptor
+ * @param capacity element count of @p rows
+ * @return number of descriptors, or -1 if @p capacity is too small
+ */
+OPTPARSE_API int optparse_packed_init(optparse_packed_t* packed, const optparse_long_t* longopts,
+                                      optparse_packed_row_t* rows, int capacity);
+
+/**
+ * @brief Parse next option using a packed-prefix matcher; behaves exactly like optparse_long().
+ * @param options   parser state
+ * @param packed    matcher filled by optparse_packed_init()
+ * @param longindex receives index into the matched longopts, or -1 for short options
+ * @return option character / shortname, -1 when done, '?' on error
+ */
+OPTPARSE_API int optparse_long_packed(optparse_t* options, const optparse_packed_t* packed, int* longindex);
+
 /**
  * @brief Retrieve next non-option argument; useful for stepping over sub-commands.
  * @param options parser state
@@ -106,6 +532,122 @@ OPTPARSE_API int optparse_long(optparse_t* options, const optparse_long_t* longo
  */
 OPTPARSE_API char* optparse_arg(optparse_t* options);
 
+/**
+ * @brief Split a command string into an argument vector in place, like a POSIX shell.
+ *
+ * Words are separated by blanks (space, tab, newline). Single quotes keep
+ * everything literally; inside double quotes a backslash only escapes
+ * $ ` " \ and newline; an unquoted backslash escapes any character, and a
+ * backslash-newline pair is removed. A '#' starting a word comments out the
+ * rest of the line. There is no expansion of any kind and no operators.
+ *
+ * Quote and escape removal only shrinks words, so they are written back into
+ * @p str and @p argv points into it: nothing is allocated. The result can be
+ * passed to optparse_init() directly; argv[0] is the first word.
+ *
+ * @param str      NUL-terminated command string, overwritten with the words
+ * @param argv     caller storage for the words and a NULL terminator
+ * @param capacity element count of @p argv
+ * @return number of words, -1 if @p argv is too small, -2 on an unterminated quote
+ */
+OPTPARSE_API int optparse_split(char* str, char** argv, int capacity);
+
+/**
+ * @brief Bump allocator over caller memory for per-request parse data.
+ *
+ * Opt-in helpers below draw the token copy, the argument vector, collected
+ * values and full error messages from it; optparse_arena_reset() releases
+ * everything in O(1), so a server can reuse one buffer across requests. The
+ * arena never allocates itself: when @c size is used up, allocations fail.
+ */
+typedef struct optparse_arena {
+    char*  base; /* caller storage */
+    size_t size; /* byte count of base */
+    size_t used; /* bytes handed out since the last reset */
+} optparse_arena_t;
+
+/**
+ * @brief Growable, NULL-terminated string list living in an arena.
+ *
+ * Zero-initialize before the first optparse_arena_append(). When the list is
+ * the most recent arena allocation it grows in place; otherwise it moves.
+ */
+typedef struct optparse_list {
+    char** items; /* items[count] is NULL once anything was appended */
+    int    count;
+    int    cap;   /* internal: allocated slots, including the terminator */
+} optparse_list_t;
+
+/**
+ * @brief Set up an arena over caller memory.
+ * @param arena arena to initialize
+ * @param mem   caller storage, kept for the lifetime of the arena
+ * @param size  byte count of @p mem
+ */
+OPTPARSE_API void optparse_arena_init(optparse_arena_t* arena, void* mem, size_t size);
+
+/**
+ * @brief Release every allocation at once.
+ * @param arena arena to reset
+ */
+OPTPARSE_API void optparse_arena_reset(optparse_arena_t* arena);
+
+/**
+ * @brief Allocate @p size bytes aligned for any pointer or integer type.
+ * @param arena arena to allocate from
+ * @param size  byte count
+ * @return the memory, or NULL if the arena is exhausted
+ */
+OPTPARSE_API void* optparse_arena_alloc(optparse_arena_t* arena, size_t size);
+
+/**
+ * @brief Copy @p str into the arena and split it with optparse_split().
+ *
+ * The argument vector is sized to the actual word count. On failure nothing
+ * stays allocated.
+ *
+ * @param arena arena to allocate from
+ * @param str   command string; left unmodified
+ * @param argv  receives the NULL-terminated vector
+ * @return number of words, -1 if the arena is exhausted, -2 on an unterminated quote
+ */
+OPTPARSE_API int optparse_arena_split(optparse_arena_t* arena, const char* str, char*** argv);
+
+/**
+ * @brief Append @p item to a list, e.g. a repeated option's values or the positionals.
+ * @param arena arena to allocate from
+ * @param list  list to extend
+ * @param item  string to append; not copied
+ * @return 0, or -1 if the arena is exhausted (the list is unchanged)
+ */
+OPTPARSE_API int optparse_arena_append(optparse_arena_t* arena, optparse_list_t* list, char* item);
+
+/**
+ * @brief Format the last error in full; errmsg holds the same text cut to 63 bytes.
+ * @param arena   arena to allocate from
+ * @param options parser state that just returned '?'; the error's argument must still be alive
+ * @return NUL-terminated message, or NULL if there is no error or the arena is exhausted
+ */
+OPTPARSE_API char* optparse_arena_error(optparse_arena_t* arena, const optparse_t* options);
+
+/**
+ * @brief Parse options straight into caller storage.
+ *
+ * Applies binds[i] for every occurrence of longopts[i] and keeps going, so
+ * bound options never come back to the caller. Unbound options (such as
+ * --help) are returned like optparse_long_id() does, and parsing resumes
+ * with the next call. An integer that does not parse or an exhausted arena
+ * is an error like any other: OPTPARSE_ID_ERROR with errmsg set.
+ *
+ * @param options  parser state
+ * @param longopts long option descriptor array, terminated with {0, 0, OPTPARSE_NONE, NULL}
+ * @param binds    one binding per descriptor in @p longopts
+ * @param arena    arena for OPTPARSE_BIND_APPEND lists; may be NULL without them
+ * @return index of an unbound option, or OPTPARSE_ID_DONE, OPTPARSE_ID_ERROR, OPTPARSE_ID_POSITIONAL
+ */
+OPTPARSE_API int optparse_long_bind(optparse_t* options, const optparse_long_t* longopts, const optparse_bind_t* binds,
+                                    optparse_arena_t* arena);
+
 /**
  * @brief Help formatter layout configuration.
  *
@@ -175,6 +717,12 @@ OPTPARSE_API void optparse_help(optparse_write_cb write, void* userdata, const o
  * ====================================================================== */
 #ifdef OPTPARSE_IMPLEMENTATION
 
+/* SSE2 is part of x86-64, so no runtime check is needed; define OPTPARSE_NO_SIMD to use the scalar loops */
+#if !defined(OPTPARSE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define OPTPARSE__SSE2
+#include <emmintrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -182,6 +730,19 @@ extern "C" {
 #define OPTPARSE_MSG_INVALID "invalid option"
 #define OPTPARSE_MSG_MISSING "option requires an argument"
 #define OPTPARSE_MSG_TOOMANY "option takes no arguments"
+#define OPTPARSE_MSG_NOSPACE "too many arguments"
+#define OPTPARSE_MSG_AMBIGUOUS "ambiguous option"
+#define OPTPARSE_MSG_INTEGER "invalid integer"
+
+/* internal: option source for the shared scan loop; index or lookup, when set, accelerates longopts */
+typedef struct optparse__spec {
+    const char*                 optstring;
+    const optparse_shortopts_t* shortopts;
+    const optparse_long_t*      longopts;
+    const optparse_index_t*     index;
+    const optparse_lookup_t*    lookup;
+    int                         abbrev; /* accept unique prefixes of long names; needs index */
+} optparse__spec_t;
 
 static inline int optparse__strlen(const char* s) {
     int len = 0;
@@ -203,13 +764,20 @@ static inline void optparse__write_n(optparse_write_cb write, void* userdata, ch
     for (int i = 0; i < n; ++i) { optparse__write_c(write, userdata, c); }
 }
 
-static int optparse__error(optparse_t* options, const char* msg, const char* data) {
+/* @p data is the subject: @p len bytes, or up to its NUL if @p len < 0; it must outlive the call */
+static int optparse__error(optparse_t* options, const char* msg, const char* data, int len) {
     unsigned int p   = 0;
     const char*  sep = " -- '";
 
+    options->errwhat  = msg;
+    options->errdata  = data;
+    options->errlen   = len < 0 ? optparse__strlen(data) : len;
+    options->errcands = NULL;
+    len               = options->errlen;
+
     while (*msg && p < sizeof(options->errmsg) - 1) { options->errmsg[p++] = *msg++; }
     while (*sep && p < sizeof(options->errmsg) - 1) { options->errmsg[p++] = *sep++; }
-    while (*data && p < sizeof(options->errmsg) - 2) { options->errmsg[p++] = *data++; }
+    while (len-- > 0 && p < sizeof(options->errmsg) - 2) { options->errmsg[p++] = *data++; }
 
     if (p < sizeof(options->errmsg) - 1) { options->errmsg[p++] = '\''; }
     options->errmsg[p] = '\0';
@@ -217,16 +785,32 @@ static int optparse__error(optparse_t* options, const char* msg, const char* dat
     return '?';
 }
 
-static inline int optparse__is_dashdash(const char* arg) {
-    return arg && arg[0] == '-' && arg[1] == '-' && arg[2] == '\0';
+static inline int optparse__class(const char* arg) {
+    if (arg[0] != '-' || arg[1] == '\0') { return OPTPARSE_CLASS_POSITIONAL; }
+    if (arg[1] != '-') { return OPTPARSE_CLASS_SHORT; }
+    return arg[2] == '\0' ? OPTPARSE_CLASS_DASHDASH : OPTPARSE_CLASS_LONG;
+}
+
+/* byte count of each argv element, NULL if unknown */
+static inline const size_t* optparse__lengths(const optparse_t* options) {
+    return options->mode ? options->mode->lengths : NULL;
+}
+
+static inline int optparse__is_stream(const optparse_t* options) {
+    return options->mode && options->mode->wincap;
 }
 
-static inline int optparse__is_short(const char* arg) {
-    return arg && arg[0] == '-' && arg[1] != '-' && arg[1] != '\0';
+/* argv[i], or NULL past the end of a counted argv */
+static inline char* optparse__at(const optparse_t* options, int i) {
+    const optparse_mode_t* mode = options->mode;
+    return mode && mode->argc >= 0 && i >= mode->argc ? NULL : options->argv[i];
 }
 
-static inline int optparse__is_long(const char* arg) {
-    return arg && arg[0] == '-' && arg[1] == '-' && arg[2] != '\0';
+/* set optarg to @p value, which lies in argv[i], with its length when element lengths are known */
+static inline void optparse__set_optarg(optparse_t* options, char* value, int i) {
+    const size_t* lengths = optparse__lengths(options);
+    options->optarg       = value;
+    options->optarglen    = lengths ? (ptrdiff_t)lengths[i] - (value - options->argv[i]) : -1;
 }
 
 static inline int optparse__is_end(const optparse_long_t* opt) {
@@ -248,56 +832,202 @@ static int optparse__type_long(const optparse_long_t* longopts, int shortname) {
     return -1;
 }
 
-static void optparse__permute(char** argv, int from, int to, int count) {
-    for (int k = 0; k < count; ++k) {
-        char* tmp = argv[from + k];
-        for (int j = from + k; j > to + k; --j) { argv[j] = argv[j - 1]; }
-        argv[to + k] = tmp;
+static inline int optparse__type(const optparse__spec_t* spec, char c) {
+    if (spec->shortopts) { return spec->shortopts->argtype[(unsigned char)c]; }
+    if (spec->optstring) { return optparse__type_short(spec->optstring, c); }
+    if (spec->index || spec->lookup) {
+        const int i = spec->index ? spec->index->shortidx[(unsigned char)c] : spec->lookup->shortidx[(unsigned char)c];
+        return i < 0 ? -1 : (int)spec->longopts[i].argtype;
+    }
+    return optparse__type_long(spec->longopts, c);
+}
+
+static void optparse__reverse(char** argv, int from, int to) {
+    for (--to; from < to; ++from, --to) {
+        char* tmp  = argv[from];
+        argv[from] = argv[to];
+        argv[to]   = tmp;
     }
 }
 
+/*
+ * Pending layout while scanning in permute mode:
+ *   argv[optind - parked .. +nonopts)  skipped non-options, in order
+ *   followed by [.. +parked)           consumed elements, in order
+ * A consumed option simply extends the parked run. A non-option found later
+ * is rotated in front of the parked run while that run is short (parked^2 <=
+ * nonopts); otherwise the two runs are exchanged first, which moves the
+ * parked run into the consumed prefix for good. Either way both runs keep
+ * their order; a rotation moves at most sqrt(nonopts) + 1 pointers. The runs
+ * are exchanged once more when parsing stops.
+ */
+static void optparse__exchange(optparse_t* options) {
+    const int begin = options->optind - options->parked;
+    const int mid   = begin + options->nonopts;
+    const int end   = mid + options->parked;
+    optparse__reverse(options->argv, begin, mid);
+    optparse__reverse(options->argv, mid, end);
+    optparse__reverse(options->argv, begin, end);
+    options->parked = 0;
+}
+
+static void optparse__permute(optparse_t* options) {
+    if (options->nonopts && options->parked) {
+        optparse__exchange(options);
+        if (options->mode) { /* elements moved: classes and lengths no longer match their indices */
+            options->mode->classes  = NULL;
+            options->mode->nclasses = 0;
+            options->mode->lengths  = NULL;
+        }
+    }
+    options->nonopts = 0;
+    options->parked  = 0;
+}
+
+/*
+ * Offset of the first byte where the name part of @p option (which ends at
+ * '=' or NUL) ends, @p name ends, or the two differ: the one byte that
+ * decides both equality and order. Only the name is ever read, never the
+ * value after '='.
+ */
+static size_t optparse__mismatch(const char* option, const char* name) {
+    size_t k = 0;
+    for (; option[k] && option[k] != '=' && option[k] == name[k]; ++k) {}
+    return k;
+}
+
 static int optparse__match(const char* longname, const char* option) {
-    const char *a = option, *n = longname;
     if (!longname) { return 0; }
-    for (; *a && *n && *a != '='; ++a, ++n) {
-        if (*a != *n) { return 0; }
-    }
-    return *n == '\0' && (*a == '\0' || *a == '=');
+    const size_t k = optparse__mismatch(option, longname);
+    return longname[k] == '\0' && (option[k] == '\0' || option[k] == '=');
 }
 
-static char* optparse__get_value(char* option) {
-    for (; *option && *option != '='; ++option) {}
-    return *option == '=' ? option + 1 : NULL;
+/* value of an option already matched against @p longname: only '=' right after the name counts */
+static char* optparse__get_value(char* option, const char* longname) {
+    char* end = option + optparse__mismatch(option, longname);
+    return *end == '=' ? end + 1 : NULL;
 }
 
-static int optparse__find_short(const optparse_long_t* longopts, int shortname) {
-    for (int i = 0; !optparse__is_end(&longopts[i]); ++i) {
-        if (longopts[i].shortname == shortname) { return i; }
+static int optparse__find_short(const optparse__spec_t* spec, int shortname) {
+    if (spec->index) { return spec->index->shortidx[(unsigned char)shortname]; }
+    if (spec->lookup) { return spec->lookup->shortidx[(unsigned char)shortname]; }
+    for (int i = 0; !optparse__is_end(&spec->longopts[i]); ++i) {
+        if (spec->longopts[i].shortname == shortname) { return i; }
     }
     return -1;
 }
 
-static int optparse__parse_short(optparse_t* options, const char* optstring, const optparse_long_t* longopts) {
-    char* option;
+/* strcmp() of option text, which ends at '=' or NUL, against a long name */
+static int optparse__compare(const char* option, const char* longname) {
+    const size_t         k = optparse__mismatch(option, longname);
+    const unsigned char* a = (const unsigned char*)option + k;
+    const unsigned char* n = (const unsigned char*)longname + k;
+    return (*a == '=' ? 0 : (int)*a) - (int)*n;
+}
+
+/* non-empty option text that a long name starts with */
+static int optparse__is_prefix(const char* option, const char* longname) {
+    const size_t k = optparse__mismatch(option, longname);
+    return k > 0 && (option[k] == '\0' || option[k] == '=');
+}
+
+static int optparse__is_alias(const optparse_long_t* a, const optparse_long_t* b) {
+    return a->shortname && a->shortname == b->shortname && a->argtype == b->argtype;
+}
+
+/* descriptor index for the option text, -1 if none, or -2 for an ambiguous prefix whose run is span[0, 1) */
+static int optparse__find_long(const optparse__spec_t* spec, const char* option, int* span) {
+    const optparse_index_t* index = spec->index;
+    if (spec->lookup) { return spec->lookup->find(spec->lookup->table, option); }
+    if (!index) {
+        for (int i = 0; !optparse__is_end(&spec->longopts[i]); ++i) {
+            if (optparse__match(spec->longopts[i].longname, option)) { return i; }
+        }
+        return -1;
+    }
+
+    int lo = 0, hi = index->count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (optparse__compare(option, index->longopts[index->order[mid]].longname) > 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < index->count && optparse__compare(option, index->longopts[index->order[lo]].longname) == 0) {
+        return index->order[lo];
+    }
+    if (!spec->abbrev) { return -1; }
+
+    /* every name the option text abbreviates sorts right here, in one run */
+    const optparse_long_t* longopts = index->longopts;
+    int                    best     = -1;
+    int                    aliases  = 1;
+    for (hi = lo; hi < index->count && optparse__is_prefix(option, longopts[index->order[hi]].longname); ++hi) {
+        const int i = index->order[hi];
+        if (best >= 0 && !optparse__is_alias(&longopts[best], &longopts[i])) { aliases = 0; }
+        if (best < 0 || i < best) { best = i; }
+    }
+    if (aliases) { return best; }
+    span[0] = lo;
+    span[1] = hi;
+    return -2;
+}
+
+/* " (name, name)" for the candidates of an ambiguous option into out[0, cap); returns the untruncated length */
+static size_t optparse__candidates(const optparse_t* options, char* out, size_t cap) {
+    const optparse_index_t* index = (const optparse_index_t*)options->errcands;
+    const optparse__spec_t  spec  = {NULL, NULL, index->longopts, index, NULL, 1};
+    const char*             prev  = NULL;
+    size_t                  n     = 0;
+    int                     span[2];
+    optparse__find_long(&spec, options->errdata, span); /* the option text is still there: find its run again */
+    for (int k = span[0]; k < span[1]; ++k) {
+        const char* name = index->longopts[index->order[k]].longname;
+        const char* a    = name;
+        const char* b    = prev;
+        for (; b && *a && *a == *b; ++a, ++b) {}
+        if (b && *a == *b) { continue; } /* duplicate names are listed once */
+        for (const char* c = prev ? ", " : " ("; *c; ++c, ++n) {
+            if (n < cap) { out[n] = *c; }
+        }
+        for (const char* c = name; *c; ++c, ++n) {
+            if (n < cap) { out[n] = *c; }
+        }
+        prev = name;
+    }
+    if (n < cap) { out[n] = ')'; }
+    return n + 1;
+}
+
+static int optparse__ambiguous(optparse_t* options, const optparse_index_t* index, const char* option) {
+    int len = 0;
+    while (option[len] && option[len] != '=') { ++len; }
+    optparse__error(options, OPTPARSE_MSG_AMBIGUOUS, option, len);
+    options->errcands = index;
+
+    const size_t p = (size_t)optparse__strlen(options->errmsg);
+    const size_t n = optparse__candidates(options, options->errmsg + p, sizeof(options->errmsg) - 1 - p);
+    options->errmsg[p + n < sizeof(options->errmsg) - 1 ? p + n : sizeof(options->errmsg) - 1] = '\0';
+    return '?';
+}
+
+static int optparse__parse_short(optparse_t* options, const optparse__spec_t* spec) {
+    char* option = options->argv[options->optind]; /* classified as a short-option cluster by the caller */
     int   type;
     char* next;
 
     options->errmsg[0] = '\0';
     options->optopt    = 0;
     options->optarg    = NULL;
+    options->optarglen = -1;
 
-    option = options->argv[options->optind];
-    if (!option) { return -1; }
-    if (optparse__is_dashdash(option)) {
-        ++options->optind;
-        return -1;
-    }
-    if (!optparse__is_short(option)) { return -1; }
-
+    const int at = options->optind;
     option += options->subopt + 1;
     options->optopt = option[0];
-    type            = optstring ? optparse__type_short(optstring, option[0]) : optparse__type_long(longopts, option[0]);
-    next            = options->argv[options->optind + 1];
+    type            = optparse__type(spec, option[0]);
+    next            = optparse__at(options, at + 1);
 
     switch (type) {
         case OPTPARSE_NONE:
@@ -313,152 +1043,815 @@ static int optparse__parse_short(optparse_t* options, const char* optstring, con
             options->subopt = 0;
             ++options->optind;
             if (option[1]) {
-                options->optarg = option + 1;
+                optparse__set_optarg(options, option + 1, at);
             } else if (next != NULL) {
-                options->optarg = next;
+                optparse__set_optarg(options, next, at + 1);
                 ++options->optind;
             } else {
-                char str[2]     = {option[0], 0};
-                options->optarg = NULL;
-                return optparse__error(options, OPTPARSE_MSG_MISSING, str);
+                return optparse__error(options, OPTPARSE_MSG_MISSING, option, 1);
             }
             return option[0];
 
         case OPTPARSE_OPTIONAL:
             options->subopt = 0;
             ++options->optind;
-            options->optarg = option[1] ? option + 1 : NULL;
+            if (option[1]) { optparse__set_optarg(options, option + 1, at); }
             return option[0];
 
         case -1:
-        default: {
-            char str[2] = {option[0], 0};
+        default:
             ++options->optind;
             options->subopt = 0;
-            return optparse__error(options, OPTPARSE_MSG_INVALID, str);
-        }
+            return optparse__error(options, OPTPARSE_MSG_INVALID, option, 1);
     }
 }
 
-static int optparse__parse_long(optparse_t* options, const optparse_long_t* longopts, int* longindex) {
-    char* option = options->argv[options->optind];
+static int optparse__parse_long(optparse_t* options, const optparse__spec_t* spec, int* longindex) {
+    const int at     = options->optind;
+    char*     option = options->argv[at];
 
     options->errmsg[0] = '\0';
     options->optopt    = 0;
     options->optarg    = NULL;
+    options->optarglen = -1;
     option += 2;
     ++options->optind;
 
-    for (int i = 0; !optparse__is_end(&longopts[i]); ++i) {
-        const char* name = longopts[i].longname;
-        if (!optparse__match(name, option)) { continue; }
+    int       span[2];
+    const int i = optparse__find_long(spec, option, span);
+    if (i == -2) { return optparse__ambiguous(options, spec->index, option); }
+    if (i < 0) {
+        /* an unknown "--name=<huge value>" is not measured when its length is known */
+        const size_t* lengths = optparse__lengths(options);
+        const size_t  len     = lengths ? lengths[at] - 2 : 0;
+        return optparse__error(options, OPTPARSE_MSG_INVALID, option, len && len < 0x7fffffff ? (int)len : -1);
+    }
 
-        if (longindex) { *longindex = i; }
+    const optparse_long_t* opt  = &spec->longopts[i];
+    const char*            name = opt->longname;
+    if (longindex) { *longindex = i; }
 
-        options->optopt = longopts[i].shortname;
-        char* val       = optparse__get_value(option);
+    options->optopt = opt->shortname;
+    char* val       = optparse__get_value(option, name);
 
-        if (longopts[i].argtype == OPTPARSE_NONE && val != NULL) {
-            return optparse__error(options, OPTPARSE_MSG_TOOMANY, name);
-        }
+    if (opt->argtype == OPTPARSE_NONE && val != NULL) { return optparse__error(options, OPTPARSE_MSG_TOOMANY, name, -1); }
 
-        if (val != NULL) {
-            options->optarg = val;
-        } else if (longopts[i].argtype == OPTPARSE_REQUIRED) {
-            options->optarg = options->argv[options->optind];
-            if (options->optarg == NULL) {
-                return optparse__error(options, OPTPARSE_MSG_MISSING, name);
-            } else {
-                ++options->optind;
-            }
+    if (val != NULL) {
+        optparse__set_optarg(options, val, at);
+    } else if (opt->argtype == OPTPARSE_REQUIRED) {
+        char* next = optparse__at(options, at + 1);
+        if (next == NULL) {
+            return optparse__error(options, OPTPARSE_MSG_MISSING, name, -1);
+        } else {
+            optparse__set_optarg(options, next, at + 1);
+            ++options->optind;
         }
-
-        return options->optopt;
     }
 
-    return optparse__error(options, OPTPARSE_MSG_INVALID, option);
+    return options->optopt;
 }
 
 OPTPARSE_API void optparse_init(optparse_t* options, char** argv) {
     options->errmsg[0] = '\0';
     options->optarg    = NULL;
+    options->optarglen = -1;
     options->argv      = argv;
-    options->permute   = 1;
+    options->permute   = OPTPARSE_PERMUTE;
     options->optind    = argv[0] ? 1 : 0;
     options->optopt    = 0;
     options->subopt    = 0;
+    options->nonopts   = 0;
+    options->parked    = 0;
+    options->errwhat   = NULL;
+    options->errdata   = NULL;
+    options->errlen    = 0;
+    options->errcands  = NULL;
+    options->mode      = NULL;
 }
 
-OPTPARSE_API int optparse(optparse_t* options, const char* optstring) {
-    for (int i = options->optind; options->argv[i]; ++i) {
-        if (optparse__is_dashdash(options->argv[i])) {
-            const int target = options->optind;
-            if (i > target) { optparse__permute(options->argv, i, target, 1); }
-            options->optind = target + 1;
-            return -1;
+/* the parser's mode state, attaching @p mode, cleared, when it has none yet */
+static optparse_mode_t* optparse__mode(optparse_t* options, optparse_mode_t* mode) {
+    if (options->mode) { return options->mode; }
+    mode->posv     = NULL;
+    mode->poscap   = 0;
+    mode->posc     = 0;
+    mode->posnext  = 0;
+    mode->source   = NULL;
+    mode->srcdata  = NULL;
+    mode->wincap   = 0;
+    mode->bufnext  = NULL;
+    mode->bufend   = NULL;
+    mode->classes  = NULL;
+    mode->nclasses = 0;
+    mode->argc     = -1;
+    mode->lengths  = NULL;
+    options->mode  = mode;
+    return mode;
+}
+
+OPTPARSE_API void optparse_init_lengths(optparse_t* options, optparse_mode_t* mode, char** argv, int argc,
+                                        const size_t* lengths) {
+    static char* const empty[1] = {NULL};
+    optparse_init(options, argc > 0 ? argv : (char**)empty);
+    options->argv = argv;
+    mode          = optparse__mode(options, mode);
+    mode->argc    = argc;
+    mode->lengths = lengths;
+}
+
+OPTPARSE_API void optparse_init_stream(optparse_t* options, optparse_mode_t* mode, char** window, int capacity,
+                                       optparse_source_cb source, void* userdata) {
+    window[0] = window[1] = NULL;
+    optparse_init(options, window);
+    options->optind  = 1;
+    options->permute = OPTPARSE_RETURN_IN_ORDER;
+    mode             = optparse__mode(options, mode);
+    mode->source     = source;
+    mode->srcdata    = userdata;
+    mode->wincap     = capacity;
+}
+
+#if defined(__GNUC__)
+typedef size_t __attribute__((__may_alias__)) optparse__word_t;
+#else
+typedef size_t optparse__word_t;
+#endif
+
+#define OPTPARSE__ONES ((size_t)-1 / 0xff) /* 0x0101...01 */
+#define OPTPARSE__HIGH (OPTPARSE__ONES << 7) /* 0x8080...80 */
+
+/* non-zero iff some byte of w is below n (n <= 128), by the carry trick (w - n * 0x01..) & ~w & 0x80.. */
+static inline size_t optparse__has_less(size_t w, unsigned char n) {
+    return (w - OPTPARSE__ONES * n) & ~w & OPTPARSE__HIGH;
+}
+
+static inline size_t optparse__has_byte(size_t w, unsigned char c) {
+    return optparse__has_less(w ^ (OPTPARSE__ONES * c), 1);
+}
+
+/*
+ * First NUL in [p, end), or end. Aligned words are tested for a zero byte
+ * at once, so a long argument costs one load and three ALU ops per word
+ * instead of one branch per byte.
+ */
+static char* optparse__find_nul(char* p, char* end) {
+    for (; p < end && ((size_t)p & (sizeof(size_t) - 1)); ++p) {
+        if (*p == '\0') { return p; }
+    }
+    for (; end - p >= (ptrdiff_t)sizeof(size_t); p += sizeof(size_t)) {
+        if (optparse__has_less(*(const optparse__word_t*)p, 1)) { break; }
+    }
+    for (; p < end && *p; ++p) {}
+    return p;
+}
+
+static char* optparse__buffer_next(void* userdata) {
+    optparse_mode_t* mode = (optparse_mode_t*)userdata;
+    char*            arg  = mode->bufnext;
+    char*            nul  = optparse__find_nul(arg, mode->bufend);
+    if (nul == mode->bufend) { return NULL; }
+    mode->bufnext = nul + 1;
+    return arg;
+}
+
+OPTPARSE_API void optparse_init_buffer(optparse_t* options, optparse_mode_t* mode, char** window, int capacity,
+                                       char* buf, size_t len) {
+    optparse_init_stream(options, mode, window, capacity, optparse__buffer_next, mode);
+    mode->bufnext = buf;
+    mode->bufend  = buf + len;
+    window[0]     = optparse__buffer_next(mode);
+}
+
+enum {
+    OPTPARSE__LEX_BARE,   /* unquoted: stop at NUL, blanks and controls, quotes, backslash */
+    OPTPARSE__LEX_SINGLE, /* in '...': stop at NUL and ' */
+    OPTPARSE__LEX_DOUBLE, /* in "...": stop at NUL, " and backslash */
+};
+
+static inline int optparse__lex_stop(unsigned char c, int mode) {
+    switch (mode) {
+        case OPTPARSE__LEX_BARE: return c <= ' ' || c == '\'' || c == '"' || c == '\\';
+        case OPTPARSE__LEX_SINGLE: return c == '\0' || c == '\'';
+        default: return c == '\0' || c == '"' || c == '\\';
+    }
+}
+
+static inline size_t optparse__lex_word(size_t w, int mode) {
+    switch (mode) {
+        case OPTPARSE__LEX_BARE:
+            return optparse__has_less(w, ' ' + 1) | optparse__has_byte(w, '\'') | optparse__has_byte(w, '"') |
+                   optparse__has_byte(w, '\\');
+        case OPTPARSE__LEX_SINGLE: return optparse__has_less(w, 1) | optparse__has_byte(w, '\'');
+        default: return optparse__has_less(w, 1) | optparse__has_byte(w, '"') | optparse__has_byte(w, '\\');
+    }
+}
+
+/*
+ * First byte at or after p that the lexer must look at in @p mode; @p end is
+ * the string's NUL. Whole words are only loaded while they end at or before
+ * it, so nothing past the string is read.
+ */
+static char* optparse__lex_skip(char* p, const char* end, int mode) {
+    for (; (size_t)p & (sizeof(size_t) - 1); ++p) {
+        if (optparse__lex_stop((unsigned char)*p, mode)) { return p; }
+    }
+    for (; end - p >= (ptrdiff_t)sizeof(size_t); p += sizeof(size_t)) {
+        if (optparse__lex_word(*(const optparse__word_t*)p, mode)) { break; }
+    }
+    for (; !optparse__lex_stop((unsigned char)*p, mode); ++p) {}
+    return p;
+}
+
+static size_t optparse__measure(const char* s) {
+    const char* p = s;
+    while (*p) { ++p; }
+    return (size_t)(p - s);
+}
+
+/* copy [from, to) down to *out; the regions overlap only with *out <= from */
+static inline char* optparse__lex_copy(char* out, const char* from, const char* to) {
+    if (out == from) { return out + (to - from); }
+    while (from < to) { *out++ = *from++; }
+    return out;
+}
+
+static inline int optparse__is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\n';
+}
+
+/* optparse_split() over a string whose NUL is at @p end */
+static int optparse__split(char* str, const char* end, char** argv, int capacity) {
+    char* p    = str;
+    char* out  = str; /* write position: never ahead of p */
+    int   argc = 0;
+
+    if (capacity < 1) { return -1; }
+    for (;;) {
+        while (optparse__is_blank(*p)) { ++p; }
+        if (*p == '#') {
+            while (*p && *p != '\n') { ++p; }
+            continue;
         }
-        if (optparse__is_short(options->argv[i])) {
-            const int target   = options->optind;
-            options->optind    = i;
-            const int r        = optparse__parse_short(options, optstring, NULL);
-            const int consumed = options->optind - i;
-            if (i > target) { optparse__permute(options->argv, i, target, consumed); }
-            options->optind = target + consumed;
-            return r;
+        if (*p == '\0') { break; }
+        if (argc + 1 >= capacity) { return -1; }
+        argv[argc++] = out;
+
+        for (;;) {
+            char* run = optparse__lex_skip(p, end, OPTPARSE__LEX_BARE);
+            out       = optparse__lex_copy(out, p, run);
+            p         = run;
+            if (*p == '\\') {
+                if (p[1] == '\n') {
+                    p += 2; /* line continuation */
+                } else if (p[1] == '\0') {
+                    *out++ = *p++; /* nothing to escape: keep it */
+                } else {
+                    *out++ = p[1];
+                    p += 2;
+                }
+            } else if (*p == '\'') {
+                run = optparse__lex_skip(p + 1, end, OPTPARSE__LEX_SINGLE);
+                if (*run == '\0') { return -2; }
+                out = optparse__lex_copy(out, p + 1, run);
+                p   = run + 1;
+            } else if (*p == '"') {
+                for (++p;;) {
+                    run = optparse__lex_skip(p, end, OPTPARSE__LEX_DOUBLE);
+                    out = optparse__lex_copy(out, p, run);
+                    p   = run;
+                    if (*p == '"') {
+                        ++p;
+                        break;
+                    }
+                    if (*p == '\0') { return -2; }
+                    const char c = p[1]; /* backslash */
+                    if (c == '\n') {
+                        p += 2;
+                    } else if (c == '$' || c == '`' || c == '"' || c == '\\') {
+                        *out++ = c;
+                        p += 2;
+                    } else {
+                        *out++ = *p++;
+                    }
+                }
+            } else if (*p != '\0' && !optparse__is_blank(*p)) {
+                *out++ = *p++; /* a control byte: ordinary */
+            } else {
+                break;
+            }
         }
-        if (!options->permute) {
-            options->optind = i;
-            return -1;
+
+        const char end = *p;
+        *out++         = '\0'; /* may overwrite the blank at p, already read */
+        if (end == '\0') { break; }
+        ++p;
+    }
+    argv[argc] = NULL;
+    return argc;
+}
+
+OPTPARSE_API int optparse_split(char* str, char** argv, int capacity) {
+    return optparse__split(str, str + optparse__measure(str), argv, capacity);
+}
+
+/* pointer-sized alignment covers every type the helpers store */
+#define OPTPARSE__ARENA_ALIGN (sizeof(void*) > sizeof(long long) ? sizeof(void*) : sizeof(long long))
+
+static void* optparse__arena_take(optparse_arena_t* arena, size_t size, size_t align) {
+    const size_t addr = (size_t)(arena->base + arena->used);
+    const size_t pad  = (align - addr % align) % align;
+    if (pad > arena->size - arena->used || size > arena->size - arena->used - pad) { return NULL; }
+    arena->used += pad;
+    void* p = arena->base + arena->used;
+    arena->used += size;
+    return p;
+}
+
+OPTPARSE_API void optparse_arena_init(optparse_arena_t* arena, void* mem, size_t size) {
+    arena->base = (char*)mem;
+    arena->size = mem ? size : 0;
+    arena->used = 0;
+}
+
+OPTPARSE_API void optparse_arena_reset(optparse_arena_t* arena) {
+    arena->used = 0;
+}
+
+OPTPARSE_API void* optparse_arena_alloc(optparse_arena_t* arena, size_t size) {
+    return optparse__arena_take(arena, size, OPTPARSE__ARENA_ALIGN);
+}
+
+OPTPARSE_API int optparse_arena_split(optparse_arena_t* arena, const char* str, char*** argv) {
+    const size_t mark = arena->used;
+    const size_t len  = (size_t)optparse__strlen(str);
+    char*        text = (char*)optparse__arena_take(arena, len + 1, 1);
+    if (!text) { return -1; }
+    for (size_t k = 0; k <= len; ++k) { text[k] = str[k]; }
+
+    /* lend the rest of the arena to the vector, then keep only what was used */
+    char** v = (char**)optparse__arena_take(arena, 0, sizeof(char*));
+    if (!v) {
+        arena->used = mark;
+        return -1;
+    }
+    const size_t room = (arena->size - arena->used) / sizeof(char*);
+    const int    n    = optparse__split(text, text + len, v, room > 0x7fffffff ? 0x7fffffff : (int)room);
+    if (n < 0) {
+        arena->used = mark;
+        return n;
+    }
+    arena->used += (size_t)(n + 1) * sizeof(char*);
+    *argv = v;
+    return n;
+}
+
+OPTPARSE_API int optparse_arena_append(optparse_arena_t* arena, optparse_list_t* list, char* item) {
+    if (list->count + 1 >= list->cap) {
+        const int    nc  = list->cap ? list->cap * 2 : 8;
+        const size_t old = (size_t)list->cap * sizeof(char*);
+        char**       top = (char**)(arena->base + arena->used);
+        if (list->items && list->items + list->cap == top &&
+            (size_t)(nc - list->cap) * sizeof(char*) <= arena->size - arena->used) {
+            arena->used += (size_t)nc * sizeof(char*) - old; /* last allocation: grow in place */
+        } else {
+            char** items = (char**)optparse__arena_take(arena, (size_t)nc * sizeof(char*), sizeof(char*));
+            if (!items) { return -1; }
+            for (int k = 0; k < list->count; ++k) { items[k] = list->items[k]; }
+            list->items = items;
         }
+        list->cap = nc;
     }
-    return -1;
+    list->items[list->count++] = item;
+    list->items[list->count]   = NULL;
+    return 0;
+}
+
+OPTPARSE_API char* optparse_arena_error(optparse_arena_t* arena, const optparse_t* options) {
+    if (!options->errmsg[0] || !options->errwhat) { return NULL; }
+    const char*  sep   = " -- '";
+    const int    what  = optparse__strlen(options->errwhat);
+    const size_t cands = options->errcands ? optparse__candidates(options, NULL, 0) : 0;
+    const size_t len   = (size_t)what + 5 + (size_t)options->errlen + 1 + cands;
+    char*        out   = (char*)optparse__arena_take(arena, len + 1, 1);
+    char*        p     = out;
+    if (!out) { return NULL; }
+    for (int k = 0; k < what; ++k) { *p++ = options->errwhat[k]; }
+    while (*sep) { *p++ = *sep++; }
+    for (int k = 0; k < options->errlen; ++k) { *p++ = options->errdata[k]; }
+    *p++ = '\'';
+    if (cands) { p += optparse__candidates(options, p, cands); }
+    *p = '\0';
+    return out;
+}
+
+/*
+ * Stream mode: keep argv[optind] and argv[optind + 1] filled. Consumed
+ * elements are dropped by sliding the live ones down to slot 1 only when the
+ * lookahead runs short, so a window larger than the minimum is shifted
+ * rarely and each argument is moved a bounded number of times.
+ */
+static void optparse__refill(optparse_t* options) {
+    optparse_mode_t* mode = options->mode;
+    char**           w    = options->argv;
+    int              n    = 0;
+
+    if (w[options->optind] && w[options->optind + 1]) { return; }
+    for (int k = options->optind; w[k]; ++k) { w[1 + n++] = w[k]; }
+    options->optind = 1;
+    while (mode->source && 1 + n < mode->wincap - 1) {
+        char* arg = mode->source(mode->srcdata);
+        if (arg == NULL) {
+            mode->source = NULL;
+            break;
+        }
+        w[1 + n++] = arg;
+    }
+    w[1 + n] = NULL;
+}
+
+OPTPARSE_API void optparse_record(optparse_t* options, optparse_mode_t* mode, int* positions, int capacity) {
+    mode          = optparse__mode(options, mode);
+    mode->posv    = positions;
+    mode->poscap  = capacity;
+    mode->posc    = 0;
+    mode->posnext = 0;
+}
+
+#if defined(__GNUC__)
+#define OPTPARSE__PREFETCH(p) __builtin_prefetch(p)
+#else
+#define OPTPARSE__PREFETCH(p) ((void)(p))
+#endif
+#define OPTPARSE__PREFETCH_AHEAD 16 /* elements: enough misses in flight to cover memory latency */
+
+OPTPARSE_API void optparse_prescan(char* const* argv, int begin, int end, unsigned char* classes, size_t* lengths) {
+    for (int i = begin; i < end; ++i) {
+        if (end - i > OPTPARSE__PREFETCH_AHEAD) { OPTPARSE__PREFETCH(argv[i + OPTPARSE__PREFETCH_AHEAD]); }
+        classes[i] = (unsigned char)optparse__class(argv[i]);
+        if (lengths) { lengths[i] = optparse__measure(argv[i]); }
+    }
+}
+
+OPTPARSE_API void optparse_classify(char* const* argv, int begin, int end, unsigned char* classes) {
+    optparse_prescan(argv, begin, end, classes, NULL);
+}
+
+OPTPARSE_API void optparse_classes(optparse_t* options, optparse_mode_t* mode, const unsigned char* classes,
+                                   int count) {
+    if (optparse__is_stream(options)) { return; }
+    mode           = optparse__mode(options, mode);
+    mode->classes  = classes;
+    mode->nclasses = count;
 }
 
 OPTPARSE_API char* optparse_arg(optparse_t* options) {
-    char* option    = options->argv[options->optind];
+    optparse_mode_t* mode = options->mode;
+    char*            option;
     options->subopt = 0;
+    if (mode && mode->posnext < mode->posc) { return options->argv[mode->posv[mode->posnext++]]; }
+    if (optparse__is_stream(options)) { optparse__refill(options); }
+    if (options->nonopts) {
+        /* pop the first pending non-option in place: it becomes part of the consumed prefix */
+        option = options->argv[options->optind - options->parked];
+        ++options->optind;
+        if (--options->nonopts == 0) { options->parked = 0; }
+        return option;
+    }
+    option = optparse__at(options, options->optind);
     if (option != NULL) { ++options->optind; }
     return option;
 }
 
-OPTPARSE_API int optparse_long(optparse_t* options, const optparse_long_t* longopts, int* longindex) {
-    for (int i = options->optind; options->argv[i]; ++i) {
-        char* arg = options->argv[i];
-        if (optparse__is_dashdash(arg)) {
-            const int target = options->optind;
-            if (i > target) { optparse__permute(options->argv, i, target, 1); }
-            options->optind = target + 1;
-            return -1;
+static int optparse__consume(optparse_t* options, const optparse__spec_t* spec, int* longindex, int i,
+                             int is_short) {
+    const int target = options->optind;
+    options->optind  = i;
+    int r;
+    if (is_short) {
+        r = optparse__parse_short(options, spec);
+        if (spec->longopts && r != -1 && longindex != NULL) {
+            *longindex = optparse__find_short(spec, options->optopt);
         }
+    } else {
+        r = optparse__parse_long(options, spec, longindex);
+    }
 
-        const int is_short = optparse__is_short(arg);
-        const int is_long  = optparse__is_long(arg);
-
-        if (is_short || is_long) {
-            const int target = options->optind;
-            options->optind  = i;
-            int r;
-            if (is_short) {
-                r = optparse__parse_short(options, NULL, longopts);
-                if (r != -1 && longindex != NULL) { *longindex = optparse__find_short(longopts, options->optopt); }
-            } else {
-                r = optparse__parse_long(options, longopts, longindex);
-            }
+    const int consumed = options->optind - i;
+    options->optind    = target + consumed;
+    if (options->nonopts) { options->parked += consumed; }
+    return r;
+}
 
-            const int consumed = options->optind - i;
-            if (i > target) { optparse__permute(options->argv, i, target, consumed); }
-            options->optind = target + consumed;
-            return r;
+/* returns like optparse_long(); *argind receives the argv index of the element that produced the result */
+static int optparse__next(optparse_t* options, const optparse__spec_t* spec, int* longindex, int* argind) {
+    optparse_mode_t* mode = options->mode;
+    if (optparse__is_stream(options)) { optparse__refill(options); }
+    int i = options->optind + options->nonopts; /* scan cursor: everything before it is classified */
+    *argind = i;
+    if (options->subopt) { return optparse__consume(options, spec, longindex, i, 1); }
+
+    for (;; *argind = ++i) {
+        char* arg = optparse__at(options, i);
+        if (arg == NULL) {
+            optparse__permute(options);
+            return -1;
+        }
+        const int cls = mode && i < mode->nclasses ? mode->classes[i] : optparse__class(arg);
+        if (cls == OPTPARSE_CLASS_DASHDASH) {
+            ++options->optind;
+            if (options->nonopts) { ++options->parked; }
+            optparse__permute(options);
+            return -1;
         }
+        if (cls == OPTPARSE_CLASS_SHORT) { return optparse__consume(options, spec, longindex, i, 1); }
+        if (cls == OPTPARSE_CLASS_LONG && spec->longopts) { return optparse__consume(options, spec, longindex, i, 0); }
 
         if (!options->permute) {
-            options->optind = i;
+            optparse__permute(options);
             return -1;
         }
+        if (options->permute == OPTPARSE_RETURN_IN_ORDER || optparse__is_stream(options)) {
+            options->errmsg[0] = '\0';
+            options->optopt    = 0;
+            optparse__set_optarg(options, arg, i);
+            ++options->optind;
+            if (options->nonopts) { ++options->parked; }
+            if (longindex) { *longindex = -1; }
+            return 1;
+        }
+        if (mode && mode->posv) {
+            if (mode->posnext == mode->posc) { mode->posc = mode->posnext = 0; }
+            if (mode->posc == mode->poscap) {
+                options->optopt    = 0;
+                options->optarg    = NULL;
+                options->optarglen = -1;
+                return optparse__error(options, OPTPARSE_MSG_NOSPACE, arg, -1);
+            }
+            mode->posv[mode->posc++] = i;
+            options->optind          = i + 1;
+            continue;
+        }
+        if (options->parked && options->parked <= options->nonopts / options->parked) {
+            const int slot = options->optind - options->parked + options->nonopts;
+            for (int j = i; j > slot; --j) { options->argv[j] = options->argv[j - 1]; }
+            options->argv[slot] = arg;
+        } else if (options->parked) {
+            optparse__exchange(options);
+        }
+        ++options->nonopts;
+    }
+}
+
+OPTPARSE_API int optparse(optparse_t* options, const char* optstring) {
+    const optparse__spec_t spec = {optstring, NULL, NULL, NULL, NULL, 0};
+    int                    argind;
+    return optparse__next(options, &spec, NULL, &argind);
+}
+
+OPTPARSE_API void optparse_compile_short(optparse_shortopts_t* table, const char* optstring) {
+    for (int c = 0; c < 256; ++c) { table->argtype[c] = -1; }
+    for (; *optstring; ++optstring) {
+        const unsigned char c = (unsigned char)*optstring;
+        if (c == ':' || table->argtype[c] != -1) { continue; }  // first occurrence wins, as in optparse()
+        if (optstring[1] == ':') {
+            table->argtype[c] = (signed char)(optstring[2] == ':' ? OPTPARSE_OPTIONAL : OPTPARSE_REQUIRED);
+        } else {
+            table->argtype[c] = (signed char)OPTPARSE_NONE;
+        }
+    }
+}
+
+OPTPARSE_API int optparse_short(optparse_t* options, const optparse_shortopts_t* table) {
+    const optparse__spec_t spec = {NULL, table, NULL, NULL, NULL, 0};
+    int                    argind;
+    return optparse__next(options, &spec, NULL, &argind);
+}
+
+OPTPARSE_API int optparse_long(optparse_t* options, const optparse_long_t* longopts, int* longindex) {
+    const optparse__spec_t spec = {NULL, NULL, longopts, NULL, NULL, 0};
+    int                    argind;
+    return optparse__next(options, &spec, longindex, &argind);
+}
+
+static int optparse__all(optparse_t* options, const optparse__spec_t* spec, optparse_event_t* events, int capacity) {
+    int n = 0;
+    while (n < capacity) {
+        int       longindex = -1, argind;
+        const int r         = optparse__next(options, spec, &longindex, &argind);
+        if (r == -1) { break; }
+
+        optparse_event_t* ev = &events[n++];
+        ev->option           = r;
+        ev->longindex        = longindex;
+        ev->argind           = argind;
+        ev->optarg           = options->optarg;
+        if (r == '?') { break; }
     }
+    return n;
+}
+
+OPTPARSE_API int optparse_long_all(optparse_t* options, const optparse_long_t* longopts, optparse_event_t* events,
+                                   int capacity) {
+    const optparse__spec_t spec = {NULL, NULL, longopts, NULL, NULL, 0};
+    return optparse__all(options, &spec, events, capacity);
+}
+
+OPTPARSE_API int optparse_long_id(optparse_t* options, const optparse_long_t* longopts) {
+    const optparse__spec_t spec      = {NULL, NULL, longopts, NULL, NULL, 0};
+    int                    longindex = -1, argind;
+    const int              r         = optparse__next(options, &spec, &longindex, &argind);
+    if (r == -1) { return OPTPARSE_ID_DONE; }
+    if (options->errmsg[0]) { return OPTPARSE_ID_ERROR; } /* cleared by every other result */
+    return longindex >= 0 ? longindex : OPTPARSE_ID_POSITIONAL;
+}
+
+/* optional sign and decimal digits only; 0 on anything else or overflow */
+static int optparse__to_long(const char* s, long* out) {
+    const int           neg   = *s == '-';
+    const unsigned long max   = ((unsigned long)-1 >> 1) + (unsigned long)neg;
+    unsigned long       value = 0;
+    if (*s == '-' || *s == '+') { ++s; }
+    if (!*s) { return 0; }
+    for (; *s; ++s) {
+        const unsigned digit = (unsigned)(*s - '0');
+        if (digit > 9 || value > (max - digit) / 10) { return 0; }
+        value = value * 10 + digit;
+    }
+    *out = !neg ? (long)value : value ? -(long)(value - 1) - 1 : 0; /* -LONG_MAX - 1 without overflow */
+    return 1;
+}
+
+OPTPARSE_API int optparse_long_bind(optparse_t* options, const optparse_long_t* longopts, const optparse_bind_t* binds,
+                                    optparse_arena_t* arena) {
+    for (;;) {
+        const int id = optparse_long_id(options, longopts);
+        if (id < 0) { return id; }
+
+        const optparse_bind_t* bind = &binds[id];
+        char*                  arg  = options->optarg;
+        switch (bind->action) {
+            case OPTPARSE_BIND_STRING: *(char**)bind->dest = arg; break;
+            case OPTPARSE_BIND_FLAG: *(int*)bind->dest = 1; break;
+            case OPTPARSE_BIND_COUNT: ++*(int*)bind->dest; break;
+            case OPTPARSE_BIND_APPEND:
+                if (arg && optparse_arena_append(arena, (optparse_list_t*)bind->dest, arg) < 0) {
+                    optparse__error(options, OPTPARSE_MSG_NOSPACE, arg, -1);
+                    return OPTPARSE_ID_ERROR;
+                }
+                break;
+            case OPTPARSE_BIND_INT:
+                if (arg && !optparse__to_long(arg, (long*)bind->dest)) {
+                    optparse__error(options, OPTPARSE_MSG_INTEGER, arg, -1);
+                    return OPTPARSE_ID_ERROR;
+                }
+                break;
+            default: return id;
+        }
+    }
+}
+
+/* strict weak order for the index: by name, ties by position so the first duplicate wins */
+static int optparse__index_less(const optparse_long_t* longopts, int a, int b) {
+    const unsigned char* x = (const unsigned char*)longopts[a].longname;
+    const unsigned char* y = (const unsigned char*)longopts[b].longname;
+    for (; *x && *x == *y; ++x, ++y) {}
+    return *x != *y ? *x < *y : a < b;
+}
+
+static void optparse__index_sift(const optparse_long_t* longopts, int* order, int root, int n) {
+    for (int child; (child = 2 * root + 1) < n; root = child) {
+        if (child + 1 < n && optparse__index_less(longopts, order[child], order[child + 1])) { ++child; }
+        if (!optparse__index_less(longopts, order[root], order[child])) { return; }
+        const int tmp = order[root];
+        order[root]   = order[child];
+        order[child]  = tmp;
+    }
+}
+
+static void optparse__shortidx(int* shortidx, const optparse_long_t* longopts) {
+    for (int c = 0; c < 256; ++c) { shortidx[c] = -1; }
+    for (int i = 0; !optparse__is_end(&longopts[i]); ++i) {
+        const int s = longopts[i].shortname;
+        /* only shortnames representable as a char can ever match an option byte */
+        if ((int)(char)s == s && shortidx[(unsigned char)s] < 0) { shortidx[(unsigned char)s] = i; }
+    }
+}
+
+OPTPARSE_API int optparse_index_init(optparse_index_t* index, const optparse_long_t* longopts, int* order,
+                                     int capacity) {
+    int n = 0;
+    optparse__shortidx(index->shortidx, longopts);
+    for (int i = 0; !optparse__is_end(&longopts[i]); ++i) {
+        if (!longopts[i].longname) { continue; }
+        if (n == capacity) { return -1; }
+        order[n++] = i;
+    }
+
+    /* heapsort: no allocation, O(n log n) once */
+    for (int i = n / 2 - 1; i >= 0; --i) { optparse__index_sift(longopts, order, i, n); }
+    for (int end = n - 1; end > 0; --end) {
+        const int tmp = order[0];
+        order[0]      = order[end];
+        order[end]    = tmp;
+        optparse__index_sift(longopts, order, 0, end);
+    }
+
+    index->longopts = longopts;
+    index->order    = order;
+    index->count    = n;
+    return n;
+}
+
+OPTPARSE_API int optparse_long_indexed(optparse_t* options, const optparse_index_t* index, int* longindex) {
+    const optparse__spec_t spec = {NULL, NULL, index->longopts, index, NULL, 0};
+    int                    argind;
+    return optparse__next(options, &spec, longindex, &argind);
+}
+
+OPTPARSE_API int optparse_long_abbrev(optparse_t* options, const optparse_index_t* index, int* longindex) {
+    const optparse__spec_t spec = {NULL, NULL, index->longopts, index, NULL, 1};
+    int                    argind;
+    return optparse__next(options, &spec, longindex, &argind);
+}
+
+OPTPARSE_API int optparse_long_lookup(optparse_t* options, const optparse_lookup_t* lookup, int* longindex) {
+    const optparse__spec_t spec = {NULL, NULL, lookup->longopts, NULL, lookup, 0};
+    int                    argind;
+    return optparse__next(options, &spec, longindex, &argind);
+}
+
+#define OPTPARSE__ROW_WORDS (16 / sizeof(size_t))
+
+OPTPARSE_API int optparse_packed_init(optparse_packed_t* packed, const optparse_long_t* longopts,
+                                      optparse_packed_row_t* rows, int capacity) {
+    int n = 0;
+    for (; !optparse__is_end(&longopts[n]); ++n) {
+        if (n == capacity) { return -1; }
+        unsigned char* head = (unsigned char*)rows[n].head;
+        const char*    name = longopts[n].longname;
+        int            k    = 0;
+        /* a missing name gets a 0xff head, which no option text can produce: it stops at NUL */
+        for (; name && k < 16 && name[k]; ++k) { head[k] = (unsigned char)name[k]; }
+        for (; k < 16; ++k) { head[k] = name ? 0 : 0xff; }
+    }
+    optparse__shortidx(packed->shortidx, longopts);
+    packed->longopts = longopts;
+    packed->rows     = rows;
+    packed->count    = n;
+    return n;
+}
+
+/* the first 16 bytes of the option's name part, NUL padded: what optparse_packed_init() stores per name */
+static inline void optparse__packed_key(const char* option, size_t* key) {
+    for (size_t w = 0; w < OPTPARSE__ROW_WORDS; ++w) { key[w] = 0; }
+    unsigned char* bytes = (unsigned char*)key;
+    for (int k = 0; k < 16 && option[k] && option[k] != '='; ++k) { bytes[k] = (unsigned char)option[k]; }
+}
+
+/* first row equal to the option's key that also matches in full, or -1 */
+static int optparse__packed_find(const void* table, const char* option) {
+    const optparse_packed_t*     packed = (const optparse_packed_t*)table;
+    const optparse_packed_row_t* rows   = packed->rows;
+    const int                    n      = packed->count;
+    int                          i      = 0;
+#ifdef OPTPARSE__SSE2
+    /* the key is assembled in registers: a byte-wise copy reloaded as a vector would stall store forwarding */
+    unsigned long long half[2] = {0, 0};
+    for (int k = 0; k < 16 && option[k] && option[k] != '='; ++k) {
+        half[k >> 3] |= (unsigned long long)(unsigned char)option[k] << (8 * (k & 7));
+    }
+    const __m128i key = _mm_set_epi64x((long long)half[1], (long long)half[0]);
+#define OPTPARSE__ROW_EQ(j) \
+    (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)rows[j].head), key)) == 0xffff)
+    /* four rows per branch; only a hit goes back to find which row it was */
+    for (; i + 4 <= n; i += 4) {
+        if (OPTPARSE__ROW_EQ(i) | OPTPARSE__ROW_EQ(i + 1) | OPTPARSE__ROW_EQ(i + 2) | OPTPARSE__ROW_EQ(i + 3)) {
+            for (int j = i; j < i + 4; ++j) {
+                if (OPTPARSE__ROW_EQ(j) && optparse__match(packed->longopts[j].longname, option)) { return j; }
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        if (OPTPARSE__ROW_EQ(i) && optparse__match(packed->longopts[i].longname, option)) { return i; }
+    }
+#undef OPTPARSE__ROW_EQ
+#else
+    size_t key[OPTPARSE__ROW_WORDS];
+    optparse__packed_key(option, key);
+    for (; i < n; ++i) {
+        size_t diff = 0;
+        for (size_t w = 0; w < OPTPARSE__ROW_WORDS; ++w) { diff |= rows[i].head[w] ^ key[w]; }
+        if (!diff && optparse__match(packed->longopts[i].longname, option)) { return i; }
+    }
+#endif
     return -1;
 }
 
+OPTPARSE_API int optparse_long_packed(optparse_t* options, const optparse_packed_t* packed, int* longindex) {
+    const optparse_lookup_t lookup = {packed->longopts, optparse__packed_find, packed, packed->shortidx};
+    return optparse_long_lookup(options, &lookup, longindex);
+}
+
 static inline optparse_help_config_t optparse__resolve_config(const optparse_help_config_t* cfg) {
     optparse_help_config_t r = OPTPARSE_HELP_CONFIG_INIT;
     if (cfg) {
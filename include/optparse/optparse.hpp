@@ -0,0 +1,598 @@
+/**
+ * @file optparse.hpp
+ * @brief Compile-time perfect-hash option tables for C++ users of optparse.
+ *
+ * OPTPARSE_TABLE(longopts) turns a namespace-scope constexpr optparse_long_t
+ * array into a type whose parse() behaves exactly like optparse_long() over
+ * the same array, but resolves "--name" with one hash of the name and one
+ * memcmp() instead of a scan. Everything is computed by the compiler: there
+ * is no startup cost, and a duplicate long name or short option character
+ * is a static_assert failure.
+ *
+ *     static constexpr optparse_long_t kLongopts[] = {
+ *         {"amend", 'a', OPTPARSE_NONE},
+ *         {"color", 'c', OPTPARSE_OPTIONAL},
+ *         {nullptr, 0, OPTPARSE_NONE},
+ *     };
+ *     using Options = OPTPARSE_TABLE(kLongopts);    // C++17: optparse_table<kLongopts>
+ *     while ((c = Options::parse(&options, &longindex)) != -1) { ... }
+ *
+ * The hash is two-level (FKS): names are split into buckets, and each
+ * bucket gets its own seed and a power-of-two slot range at least the
+ * square of its size, so there is never a probe. Tables stay within about
+ * six slots per name. The header is C++11, where building the tables
+ * takes quadratic compile time and suits up to a few hundred options; with
+ * C++14 relaxed constexpr they are built in linear time, which makes tables
+ * of thousands of options practical.
+ *
+ * Include it after optparse.h; the implementation of optparse.h must be
+ * linked as usual.
+ *
+ * This is free and unencumbered software released into the public domain.
+ */
+#ifndef OPTPARSE_OPTPARSE_HPP
+#define OPTPARSE_OPTPARSE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "optparse.h"
+
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304L
+#define OPTPARSE__CXX14 1 /* loops in constexpr functions */
+#else
+#define OPTPARSE__CXX14 0
+#endif
+#if defined(__cpp_nontype_template_parameter_auto) && __cpp_nontype_template_parameter_auto >= 201606L
+#define OPTPARSE__CXX17 1 /* template <const auto&> and inline static members */
+#else
+#define OPTPARSE__CXX17 0
+#endif
+
+#ifndef OPTPARSE_TABLE_SEEDS
+#define OPTPARSE_TABLE_SEEDS 128 /* seeds tried per level before giving up */
+#endif
+
+namespace optparse_detail {
+
+typedef std::uint64_t u64;
+typedef std::uint32_t u32;
+
+static constexpr u64 kFnvOffset = 14695981039346656037ull;
+static constexpr u64 kFnvPrime  = 1099511628211ull;
+
+template <class T, std::size_t N>
+struct array {
+    T v[N ? N : 1];
+};
+
+template <std::size_t... I>
+struct index_sequence {};
+
+template <class A, class B>
+struct concat;
+template <std::size_t... I, std::size_t... J>
+struct concat<index_sequence<I...>, index_sequence<J...>> {
+    typedef index_sequence<I..., (sizeof...(I) + J)...> type;
+};
+
+/* halves at every step, so instantiation depth is logarithmic */
+template <std::size_t N>
+struct make_index_sequence {
+    typedef typename concat<typename make_index_sequence<N / 2>::type,
+                            typename make_index_sequence<N - N / 2>::type>::type type;
+};
+template <>
+struct make_index_sequence<0> {
+    typedef index_sequence<> type;
+};
+template <>
+struct make_index_sequence<1> {
+    typedef index_sequence<0> type;
+};
+
+/* sum of f(i) over [lo, hi); divide and conquer keeps C++11 constexpr recursion shallow */
+template <class F>
+constexpr int sum(const F& f, int lo, int hi) {
+    return hi - lo <= 0   ? 0
+           : hi - lo == 1 ? f(lo)
+                          : sum(f, lo, lo + (hi - lo) / 2) + sum(f, lo + (hi - lo) / 2, hi);
+}
+
+template <class F>
+constexpr int first(const F& f, int lo, int hi);
+template <class F>
+constexpr int first_or(int found, const F& f, int lo, int hi) {
+    return found >= 0 ? found : first(f, lo, hi);
+}
+/* first i in [lo, hi) with f(i), or -1 */
+template <class F>
+constexpr int first(const F& f, int lo, int hi) {
+    return hi - lo <= 0   ? -1
+           : hi - lo == 1 ? (f(lo) ? lo : -1)
+                          : first_or(first(f, lo, lo + (hi - lo) / 2), f, lo + (hi - lo) / 2, hi);
+}
+
+constexpr u64 fnv(const char* s, u64 h) {
+    return *s ? fnv(s + 1, (h ^ (unsigned char)*s) * kFnvPrime) : h;
+}
+
+constexpr int length(const char* s) {
+    return *s ? 1 + length(s + 1) : 0;
+}
+
+constexpr bool same(const char* a, const char* b) {
+    return *a == *b && (!*a || same(a + 1, b + 1));
+}
+
+constexpr u64 fold(u64 x, int r) {
+    return x ^ (x >> r);
+}
+
+/* murmur3 finalizer of the name hash under a seed: low half picks the bucket, high half the slot */
+constexpr u64 mix(u64 h, u32 seed) {
+    return fold(fold(fold(h ^ (seed * 0x9e3779b97f4a7c15ull), 33) * 0xff51afd7ed558ccdull, 33) * 0xc4ceb9fe1a85ec53ull,
+                33);
+}
+
+constexpr int bucket_of(u64 h, u32 seed, int nbuckets) {
+    return (int)((u32)mix(h, seed) & (u32)(nbuckets - 1));
+}
+
+constexpr u32 slot_of(u64 h, u32 seed, u32 mask) {
+    return (u32)(mix(h, seed) >> 32) & mask;
+}
+
+constexpr int ceil_pow2(int n, int p) {
+    return p >= n ? p : ceil_pow2(n, p * 2);
+}
+
+/* short option bytes the parser can ever see, as in optparse_index_init() */
+constexpr bool is_char(int shortname) {
+    return (int)(char)shortname == shortname;
+}
+
+struct at {
+    const int*    values;
+    constexpr int operator()(int i) const { return values[i]; }
+};
+
+struct is_value {
+    const int*     values;
+    int            value;
+    constexpr bool operator()(int i) const { return values[i] == value; }
+};
+
+struct is_negative {
+    const int*     values;
+    constexpr bool operator()(int i) const { return values[i] < 0; }
+};
+
+struct is_end {
+    const optparse_long_t* o;
+    constexpr bool         operator()(int i) const { return !o[i].longname && !o[i].shortname; }
+};
+
+struct is_named {
+    const optparse_long_t* o;
+    constexpr int          operator()(int i) const { return o[i].longname ? 1 : 0; }
+};
+
+/* an entry whose short character already belongs to an earlier entry */
+struct short_taken {
+    const optparse_long_t* o;
+    const int*             shortidx;
+    constexpr int          operator()(int i) const {
+        return o[i].shortname && is_char(o[i].shortname) && shortidx[(unsigned char)o[i].shortname] != i ? 1 : 0;
+    }
+};
+
+/* members of one bucket as seen from member x: pairs (x, y > x) sharing a slot under seed */
+struct collides_with {
+    const u64* h;
+    const int* members;
+    int        x;
+    u32        seed;
+    u32        mask;
+    constexpr int operator()(int y) const {
+        return slot_of(h[members[x]], seed, mask) == slot_of(h[members[y]], seed, mask) ? 1 : 0;
+    }
+};
+
+struct collides {
+    const u64* h;
+    const int* members;
+    int        end;
+    u32        seed;
+    u32        mask;
+    constexpr int operator()(int x) const {
+        return sum(collides_with{h, members, x, seed, mask}, x + 1, end) != 0 ? 1 : 0;
+    }
+};
+
+struct same_name_after {
+    const optparse_long_t* o;
+    const int*             members;
+    int                    x;
+    constexpr int          operator()(int y) const {
+        return same(o[members[x]].longname, o[members[y]].longname) ? 1 : 0;
+    }
+};
+
+struct same_name {
+    const optparse_long_t* o;
+    const int*             members;
+    int                    end;
+    constexpr int          operator()(int x) const { return sum(same_name_after{o, members, x}, x + 1, end); }
+};
+
+/* smallest seed placing members [begin, end) in distinct slots, or -1 */
+constexpr int find_seed(const u64* h, const int* members, int begin, int end, u32 mask, u32 seed) {
+    return end - begin <= 1 ? 0
+           : seed == OPTPARSE_TABLE_SEEDS ? -1
+           : sum(collides{h, members, end, seed, mask}, begin, end) == 0
+               ? (int)seed
+               : find_seed(h, members, begin, end, mask, seed + 1);
+}
+
+struct bucket {
+    u32 offset; /* first slot */
+    u32 mask;   /* slot count - 1 */
+    u32 seed;
+};
+
+template <std::size_t... I>
+constexpr array<u64, sizeof...(I)> make_hashes(const optparse_long_t* o, index_sequence<I...>) {
+    return {{(o[I].longname ? fnv(o[I].longname, kFnvOffset) : 0)...}};
+}
+
+template <std::size_t... I>
+constexpr array<int, sizeof...(I)> make_lengths(const optparse_long_t* o, index_sequence<I...>) {
+    return {{(o[I].longname ? length(o[I].longname) : 0)...}};
+}
+
+template <std::size_t... I>
+constexpr array<int, sizeof...(I)> make_sizes(const int* counts, index_sequence<I...>) {
+    return {{(counts[I] ? ceil_pow2(counts[I] * counts[I], 1) : 0)...}};
+}
+
+template <std::size_t... I>
+constexpr array<int, sizeof...(I)> make_seeds(const u64* h, const int* members, const int* starts, const int* counts,
+                                              const int* sizes, index_sequence<I...>) {
+    return {{find_seed(h, members, starts[I], starts[I] + counts[I], (u32)sizes[I] - 1, 0)...}};
+}
+
+template <std::size_t... I>
+constexpr array<int, sizeof...(I)> make_dupnames(const optparse_long_t* o, const int* members, const int* starts,
+                                                 const int* counts, index_sequence<I...>) {
+    return {{sum(same_name{o, members, starts[I] + counts[I]}, starts[I], starts[I] + counts[I])...}};
+}
+
+/* empty buckets share the always-empty slot after the last range */
+template <std::size_t... I>
+constexpr array<bucket, sizeof...(I)> make_buckets(const int* offsets, const int* sizes, const int* seeds, int nslots,
+                                                   index_sequence<I...>) {
+    return {{{(u32)(sizes[I] ? offsets[I] : nslots), (u32)(sizes[I] ? sizes[I] - 1 : 0),
+              (u32)(seeds[I] < 0 ? 0 : seeds[I])}...}};
+}
+
+#if OPTPARSE__CXX14
+
+inline constexpr array<int, 256> make_shortidx(const optparse_long_t* o, int count) {
+    array<int, 256> a{};
+    for (int c = 0; c < 256; ++c) { a.v[c] = -1; }
+    for (int i = count - 1; i >= 0; --i) {
+        if (is_char(o[i].shortname)) { a.v[(unsigned char)o[i].shortname] = i; }
+    }
+    return a;
+}
+
+template <int B>
+constexpr array<int, B> make_counts(const optparse_long_t* o, const u64* h, int count, u32 seed) {
+    array<int, B> a{};
+    for (int i = 0; i < count; ++i) {
+        if (o[i].longname) { ++a.v[bucket_of(h[i], seed, B)]; }
+    }
+    return a;
+}
+
+/* exclusive prefix sums */
+template <int B>
+constexpr array<int, B> make_prefix(const int* values) {
+    array<int, B> a{};
+    for (int b = 1; b < B; ++b) { a.v[b] = a.v[b - 1] + values[b - 1]; }
+    return a;
+}
+
+/* named entries grouped by bucket, in entry order within a bucket */
+template <int B, int Named>
+constexpr array<int, Named> make_members(const optparse_long_t* o, const u64* h, int count, u32 seed,
+                                         const int* starts) {
+    array<int, Named> a{};
+    array<int, B>     fill{};
+    for (int i = 0; i < count; ++i) {
+        if (!o[i].longname) { continue; }
+        const int b          = bucket_of(h[i], seed, B);
+        a.v[starts[b] + fill.v[b]++] = i;
+    }
+    return a;
+}
+
+template <int M>
+constexpr array<int, M> make_slots(const optparse_long_t* o, const u64* h, int count, u32 seed, int nbuckets,
+                                   const bucket* buckets) {
+    array<int, M> a{};
+    for (int m = 0; m < M; ++m) { a.v[m] = -1; }
+    for (int i = 0; i < count; ++i) {
+        if (!o[i].longname) { continue; }
+        const bucket& b                                  = buckets[bucket_of(h[i], seed, nbuckets)];
+        a.v[b.offset + slot_of(h[i], b.seed, b.mask)] = i;
+    }
+    return a;
+}
+
+/* smallest seed whose buckets hold at most 3n pairs in all (sum of squared sizes), or -1 */
+template <int B>
+constexpr int find_split(const optparse_long_t* o, const u64* h, int count, int named) {
+    for (u32 seed = 0; seed < OPTPARSE_TABLE_SEEDS; ++seed) {
+        const array<int, B> counts = make_counts<B>(o, h, count, seed);
+        int                 pairs  = 0;
+        for (int b = 0; b < B; ++b) { pairs += counts.v[b] * counts.v[b]; }
+        if (pairs <= 3 * named) { return (int)seed; }
+    }
+    return -1;
+}
+
+#else
+
+struct in_bucket {
+    const optparse_long_t* o;
+    const u64*             h;
+    u32                    seed;
+    int                    nbuckets;
+    int                    b;
+    constexpr int operator()(int i) const { return o[i].longname && bucket_of(h[i], seed, nbuckets) == b ? 1 : 0; }
+};
+
+/* member position of entry i: its bucket's start plus the named entries before it in the same bucket */
+struct position {
+    const optparse_long_t* o;
+    const u64*             h;
+    u32                    seed;
+    int                    nbuckets;
+    const int*             starts;
+    constexpr int          operator()(int i) const {
+        return !o[i].longname ? -1
+                                       : starts[bucket_of(h[i], seed, nbuckets)] +
+                                    sum(in_bucket{o, h, seed, nbuckets, bucket_of(h[i], seed, nbuckets)}, 0, i);
+    }
+};
+
+struct slot_at {
+    const optparse_long_t* o;
+    const u64*             h;
+    u32                    seed;
+    int                    nbuckets;
+    const bucket*          buckets;
+    constexpr int          operator()(int i) const {
+        return !o[i].longname ? -1
+                                       : (int)(buckets[bucket_of(h[i], seed, nbuckets)].offset +
+                                      slot_of(h[i], buckets[bucket_of(h[i], seed, nbuckets)].seed,
+                                              buckets[bucket_of(h[i], seed, nbuckets)].mask));
+    }
+};
+
+struct has_short {
+    const optparse_long_t* o;
+    int                    c;
+    constexpr bool operator()(int i) const { return is_char(o[i].shortname) && (unsigned char)o[i].shortname == c; }
+};
+
+template <std::size_t... I>
+constexpr array<int, sizeof...(I)> make_shortidx(const optparse_long_t* o, int count, index_sequence<I...>) {
+    return {{first(has_short{o, (int)I}, 0, count)...}};
+}
+inline constexpr array<int, 256> make_shortidx(const optparse_long_t* o, int count) {
+    return make_shortidx(o, count, make_index_sequence<256>::type());
+}
+
+struct pairs_in {
+    const optparse_long_t* o;
+    const u64*             h;
+    u32                    seed;
+    int                    nbuckets;
+    int                    count;
+    constexpr int          operator()(int i) const {
+        return o[i].longname ? sum(in_bucket{o, h, seed, nbuckets, bucket_of(h[i], seed, nbuckets)}, 0, count) : 0;
+    }
+};
+
+template <int B, std::size_t... I>
+constexpr array<int, B> make_counts(const optparse_long_t* o, const u64* h, int count, u32 seed, index_sequence<I...>) {
+    return {{sum(in_bucket{o, h, seed, B, (int)I}, 0, count)...}};
+}
+template <int B>
+constexpr array<int, B> make_counts(const optparse_long_t* o, const u64* h, int count, u32 seed) {
+    return make_counts<B>(o, h, count, seed, typename make_index_sequence<B>::type());
+}
+
+template <int B, std::size_t... I>
+constexpr array<int, B> make_prefix(const int* values, index_sequence<I...>) {
+    return {{sum(at{values}, 0, (int)I)...}};
+}
+template <int B>
+constexpr array<int, B> make_prefix(const int* values) {
+    return make_prefix<B>(values, typename make_index_sequence<B>::type());
+}
+
+template <class F, std::size_t... I>
+constexpr array<int, sizeof...(I)> make_positions(const F& p, index_sequence<I...>) {
+    return {{p((int)I)...}};
+}
+template <int Named, std::size_t... I>
+constexpr array<int, Named> make_members(const int* positions, int count, index_sequence<I...>) {
+    /* the casts keep both parameters used when no option is named and the pack is empty */
+    return (void)positions, (void)count, array<int, Named>{{first(is_value{positions, (int)I}, 0, count)...}};
+}
+template <int B, int Named, int Count>
+constexpr array<int, Named> make_members(const optparse_long_t* o, const u64* h, int count, u32 seed,
+                                         const int* starts) {
+    return make_members<Named>(
+        make_positions(position{o, h, seed, B, starts}, typename make_index_sequence<Count>::type()).v, count,
+        typename make_index_sequence<Named>::type());
+}
+
+template <int M, std::size_t... I>
+constexpr array<int, M> make_slots(const int* slots, int count, index_sequence<I...>) {
+    return {{first(is_value{slots, (int)I}, 0, count)...}};
+}
+template <int M, int Count>
+constexpr array<int, M> make_slots(const optparse_long_t* o, const u64* h, int count, u32 seed, int nbuckets,
+                                   const bucket* buckets) {
+    return make_slots<M>(
+        make_positions(slot_at{o, h, seed, nbuckets, buckets}, typename make_index_sequence<Count>::type()).v,
+        count, typename make_index_sequence<M>::type());
+}
+
+template <int B>
+constexpr int find_split(const optparse_long_t* o, const u64* h, int count, int named, u32 seed = 0) {
+    return seed == OPTPARSE_TABLE_SEEDS                             ? -1
+           : sum(pairs_in{o, h, seed, B, count}, 0, count) <= 3 * named ? (int)seed
+                                                                      : find_split<B>(o, h, count, named, seed + 1);
+}
+
+#endif
+
+}  // namespace optparse_detail
+
+/**
+ * @brief Perfect-hash lookup over a constexpr long option array; prefer OPTPARSE_TABLE() or optparse_table<>.
+ *
+ * @tparam N        element count of @p Options, terminator included
+ * @tparam Options  constexpr optparse_long_t array terminated with {0, 0, OPTPARSE_NONE, NULL}
+ */
+template <std::size_t N, const optparse_long_t (&Options)[N]>
+class optparse_static_table {
+    typedef optparse_detail::u64 u64;
+    typedef optparse_detail::u32 u32;
+
+    static constexpr int kEnd = optparse_detail::first(optparse_detail::is_end{Options}, 0, (int)N);
+    static_assert(kEnd >= 0, "optparse: option table must end with {0, 0, OPTPARSE_NONE, NULL}");
+
+public:
+    static constexpr int count = kEnd < 0 ? 0 : kEnd; /* descriptors before the terminator */
+    static constexpr int named = optparse_detail::sum(optparse_detail::is_named{Options}, 0, count);
+
+private:
+    static constexpr int kBuckets = optparse_detail::ceil_pow2(named, 1);
+
+    static constexpr optparse_detail::array<u64, count> kHash =
+        optparse_detail::make_hashes(Options, typename optparse_detail::make_index_sequence<count>::type());
+    static constexpr optparse_detail::array<int, count> kLength =
+        optparse_detail::make_lengths(Options, typename optparse_detail::make_index_sequence<count>::type());
+    static constexpr int kSplit = optparse_detail::find_split<kBuckets>(Options, kHash.v, count, named);
+    static_assert(kSplit >= 0, "optparse: no bucket split found; raise OPTPARSE_TABLE_SEEDS");
+
+    static constexpr optparse_detail::array<int, kBuckets> kCounts =
+        optparse_detail::make_counts<kBuckets>(Options, kHash.v, count, (u32)kSplit);
+    static constexpr optparse_detail::array<int, kBuckets> kStarts = optparse_detail::make_prefix<kBuckets>(kCounts.v);
+#if OPTPARSE__CXX14
+    static constexpr optparse_detail::array<int, named> kMembers =
+        optparse_detail::make_members<kBuckets, named>(Options, kHash.v, count, (u32)kSplit, kStarts.v);
+#else
+    static constexpr optparse_detail::array<int, named> kMembers =
+        optparse_detail::make_members<kBuckets, named, count>(Options, kHash.v, count, (u32)kSplit, kStarts.v);
+#endif
+    static constexpr optparse_detail::array<int, kBuckets> kSizes = optparse_detail::make_sizes(
+        kCounts.v, typename optparse_detail::make_index_sequence<kBuckets>::type());
+    static constexpr optparse_detail::array<int, kBuckets> kOffsets = optparse_detail::make_prefix<kBuckets>(kSizes.v);
+    static constexpr int kSlots = kOffsets.v[kBuckets - 1] + kSizes.v[kBuckets - 1];
+
+    static constexpr optparse_detail::array<int, kBuckets> kDupNames = optparse_detail::make_dupnames(
+        Options, kMembers.v, kStarts.v, kCounts.v, typename optparse_detail::make_index_sequence<kBuckets>::type());
+    static_assert(optparse_detail::sum(optparse_detail::at{kDupNames.v}, 0, kBuckets) == 0,
+                  "optparse: duplicate long option name");
+    static constexpr optparse_detail::array<int, kBuckets> kSeeds =
+        optparse_detail::make_seeds(kHash.v, kMembers.v, kStarts.v, kCounts.v, kSizes.v,
+                                    typename optparse_detail::make_index_sequence<kBuckets>::type());
+    static_assert(optparse_detail::sum(optparse_detail::at{kDupNames.v}, 0, kBuckets) != 0 ||
+                      optparse_detail::first(optparse_detail::is_negative{kSeeds.v}, 0, kBuckets) < 0,
+                  "optparse: no collision-free bucket seed found; raise OPTPARSE_TABLE_SEEDS");
+
+    static constexpr optparse_detail::array<optparse_detail::bucket, kBuckets> kBucket = optparse_detail::make_buckets(
+        kOffsets.v, kSizes.v, kSeeds.v, kSlots, typename optparse_detail::make_index_sequence<kBuckets>::type());
+#if OPTPARSE__CXX14
+    static constexpr optparse_detail::array<int, kSlots + 1> kSlot =
+        optparse_detail::make_slots<kSlots + 1>(Options, kHash.v, count, (u32)kSplit, kBuckets, kBucket.v);
+#else
+    static constexpr optparse_detail::array<int, kSlots + 1> kSlot =
+        optparse_detail::make_slots<kSlots + 1, count>(Options, kHash.v, count, (u32)kSplit, kBuckets, kBucket.v);
+#endif
+
+public:
+    /** @brief First entry per short option byte, -1 if none; same layout as optparse_index_t::shortidx. */
+    static constexpr optparse_detail::array<int, 256> shortidx =
+        optparse_detail::make_shortidx(Options, count);
+    static_assert(optparse_detail::sum(optparse_detail::short_taken{Options, shortidx.v}, 0, count) == 0,
+                  "optparse: duplicate short option character");
+
+    /**
+     * @brief Resolve option text after "--", which ends at '=' or NUL.
+     * @param table  unused; present for optparse_lookup_t
+     * @param option option text
+     * @return index of the matching descriptor, or -1
+     */
+    static int find(const void* table, const char* option) {
+        (void)table;
+        u64 h = optparse_detail::kFnvOffset;
+        int n = 0;
+        for (; option[n] && option[n] != '='; ++n) { h = (h ^ (unsigned char)option[n]) * optparse_detail::kFnvPrime; }
+        const optparse_detail::bucket& b = kBucket.v[optparse_detail::bucket_of(h, (u32)kSplit, kBuckets)];
+        const int                      i = kSlot.v[b.offset + optparse_detail::slot_of(h, b.seed, b.mask)];
+        return i >= 0 && kLength.v[i] == n && memcmp(option, Options[i].longname, (size_t)n) == 0 ? i : -1;
+    }
+
+    /** @brief Resolver for optparse_long_lookup(). */
+    static constexpr optparse_lookup_t lookup = {Options, &find, nullptr, shortidx.v};
+
+    /**
+     * @brief Parse next option; behaves exactly like optparse_long() over the same array.
+     * @param options   parser state
+     * @param longindex receives index into the array, or -1 for short options
+     * @return option character / shortname, -1 when done, '?' on error
+     */
+    static int parse(optparse_t* options, int* longindex) { return optparse_long_lookup(options, &lookup, longindex); }
+};
+
+#if !OPTPARSE__CXX17
+/* C++11/14: out-of-class definitions of the members used at run time */
+template <std::size_t N, const optparse_long_t (&Options)[N]>
+constexpr int optparse_static_table<N, Options>::count;
+template <std::size_t N, const optparse_long_t (&Options)[N]>
+constexpr int optparse_static_table<N, Options>::named;
+template <std::size_t N, const optparse_long_t (&Options)[N]>
+constexpr optparse_detail::array<int, optparse_static_table<N, Options>::count>
+    optparse_static_table<N, Options>::kLength;
+template <std::size_t N, const optparse_long_t (&Options)[N]>
+constexpr optparse_detail::array<optparse_detail::bucket, optparse_static_table<N, Options>::kBuckets>
+    optparse_static_table<N, Options>::kBucket;
+template <std::size_t N, const optparse_long_t (&Options)[N]>
+constexpr optparse_detail::array<int, optparse_static_table<N, Options>::kSlots + 1>
+    optparse_static_table<N, Options>::kSlot;
+template <std::size_t N, const optparse_long_t (&Options)[N]>
+constexpr optparse_detail::array<int, 256> optparse_static_table<N, Options>::shortidx;
+template <std::size_t N, const optparse_long_t (&Options)[N]>
+constexpr optparse_lookup_t optparse_static_table<N, Options>::lookup;
+#endif
+
+/** @brief Perfect-hash table type for a constexpr optparse_long_t array. */
+#define OPTPARSE_TABLE(longopts) optparse_static_table<sizeof(longopts) / sizeof((longopts)[0]), longopts>
+
+#if OPTPARSE__CXX17
+/** @brief C++17 spelling of OPTPARSE_TABLE(): optparse_table<kLongopts>. */
+template <const auto& Options>
+using optparse_table = optparse_static_table<sizeof(Options) / sizeof(Options[0]), Options>;
+#endif
+
+#endif  // OPTPARSE_OPTPARSE_HPP
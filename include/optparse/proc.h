@@ -0,0 +1,200 @@
+/**
+ * @file proc.h
+ * @brief Bulk /proc/<pid>/cmdline scanner for optparse (Linux).
+ *
+ * optparse_proc_scan() walks every process in /proc, reads its command line
+ * into one reusable buffer and hands the callback a parser already set up
+ * over it with optparse_init_buffer(), so the callback only runs its own
+ * optparse_long() loop. Nothing is allocated per process: the buffer grows
+ * to the longest command line seen and is kept across scans, and arguments
+ * point straight into it.
+ *
+ * Directory entries come in batches from getdents64 through readdir(), and
+ * each cmdline is opened relative to the /proc descriptor, so a scan costs
+ * one openat/read/close per process. Processes that exit mid-scan and kernel
+ * threads (empty cmdline) are skipped.
+ *
+ * Like response.h this module allocates and uses the OS API. Include it after
+ * defining OPTPARSE_IMPLEMENTATION in the same source file that implements
+ * optparse.h; C sources built in strict ISO mode need _POSIX_C_SOURCE set to
+ * 200809L or later before any system header.
+ *
+ * This is free and unencumbered software released into the public domain.
+ */
+#ifndef OPTPARSE_PROC_H
+#define OPTPARSE_PROC_H
+
+#include <stddef.h>
+
+#include "optparse.h"
+
+#ifndef OPTPARSE_PROC_WINDOW
+#define OPTPARSE_PROC_WINDOW 8
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Reusable scanner state; zero-initialize or call optparse_proc_init().
+ *
+ * The counters accumulate over scans until reset by the caller.
+ */
+typedef struct optparse_proc {
+    int             pid;     /* process being visited */
+    size_t          len;     /* byte count of its command line in buf */
+    char*           buf;     /* internal: cmdline buffer reused across processes */
+    size_t          cap;     /* internal: allocated bytes of buf */
+    unsigned long   visited; /* processes handed to the callback */
+    unsigned long   skipped; /* entries skipped: exited, unreadable or kernel threads */
+    unsigned long   bytes;   /* cmdline bytes read */
+    char*           window[OPTPARSE_PROC_WINDOW]; /* internal: stream window for the parser */
+    optparse_mode_t mode;    /* internal: stream state for the parser */
+} optparse_proc_t;
+
+/**
+ * @brief Callback invoked once per process.
+ * @param scan     scanner; scan->pid and scan->buf / scan->len describe the process
+ * @param options  parser over the process arguments; argv[0] is its program name
+ * @param userdata opaque context passed to optparse_proc_scan()
+ * @return 0 to continue, non-zero to stop the scan
+ */
+typedef int (*optparse_proc_cb)(optparse_proc_t* scan, optparse_t* options, void* userdata);
+
+/**
+ * @brief Initialize scanner state.
+ * @param scan scanner to initialize
+ */
+OPTPARSE_API void optparse_proc_init(optparse_proc_t* scan);
+
+/**
+ * @brief Release the cmdline buffer.
+ * @param scan scanner
+ */
+OPTPARSE_API void optparse_proc_free(optparse_proc_t* scan);
+
+/**
+ * @brief Visit every process in /proc.
+ * @param scan     scanner, reused across calls
+ * @param cb       callback run for each process with a non-empty command line
+ * @param userdata opaque context forwarded to @p cb
+ * @return number of processes visited, or -1 if /proc cannot be read or memory could not be allocated
+ */
+OPTPARSE_API long optparse_proc_scan(optparse_proc_t* scan, optparse_proc_cb cb, void* userdata);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* ======================================================================
+ * IMPLEMENTATION
+ * ====================================================================== */
+#if defined(OPTPARSE_IMPLEMENTATION) && !defined(OPTPARSE_PROC_IMPLEMENTED)
+#define OPTPARSE_PROC_IMPLEMENTED
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OPTPARSE_API void optparse_proc_init(optparse_proc_t* scan) {
+    scan->pid     = 0;
+    scan->len     = 0;
+    scan->buf     = NULL;
+    scan->cap     = 0;
+    scan->visited = 0;
+    scan->skipped = 0;
+    scan->bytes   = 0;
+}
+
+OPTPARSE_API void optparse_proc_free(optparse_proc_t* scan) {
+    free(scan->buf);
+    scan->buf = NULL;
+    scan->cap = 0;
+}
+
+/* "1234" -> 1234; 0 for anything that is not a pid directory */
+static int optparse__proc_pid(const char* name) {
+    int pid = 0;
+    for (; *name; ++name) {
+        if (*name < '0' || *name > '9' || pid > 99999999) { return 0; }
+        pid = pid * 10 + (*name - '0');
+    }
+    return pid;
+}
+
+/* read "<name>/cmdline" into scan->buf; 1 on success, 0 if unreadable or empty, -1 on allocation failure */
+static int optparse__proc_read(optparse_proc_t* scan, int procfd, const char* name) {
+    char path[32];
+    int  n = 0;
+    for (; name[n] && n < 16; ++n) { path[n] = name[n]; }
+    for (const char* s = "/cmdline"; *s; ++s) { path[n++] = *s; }
+    path[n] = '\0';
+
+    const int fd = openat(procfd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { return 0; }
+    scan->len = 0;
+    for (;;) {
+        if (scan->len == scan->cap) {
+            const size_t nc = scan->cap ? scan->cap * 2 : 4096;
+            char*        nb = (char*)realloc(scan->buf, nc);
+            if (!nb) {
+                close(fd);
+                return -1;
+            }
+            scan->buf = nb;
+            scan->cap = nc;
+        }
+        const ssize_t got = read(fd, scan->buf + scan->len, scan->cap - scan->len);
+        if (got <= 0) { break; }
+        scan->len += (size_t)got;
+    }
+    close(fd);
+    scan->bytes += scan->len;
+    if (scan->len == 0) { return 0; }
+    /* processes that rewrite their argv may drop the final NUL; the last read left room for it */
+    if (scan->buf[scan->len - 1] != '\0') { scan->buf[scan->len++] = '\0'; }
+    return 1;
+}
+
+OPTPARSE_API long optparse_proc_scan(optparse_proc_t* scan, optparse_proc_cb cb, void* userdata) {
+    DIR* dir = opendir("/proc");
+    long n   = 0;
+    if (!dir) { return -1; }
+
+    const int fd = dirfd(dir);
+    for (struct dirent* ent; (ent = readdir(dir)) != NULL;) {
+        const int pid = optparse__proc_pid(ent->d_name);
+        if (pid <= 0) { continue; }
+
+        const int r = optparse__proc_read(scan, fd, ent->d_name);
+        if (r < 0) {
+            n = -1;
+            break;
+        }
+        if (r == 0) {
+            ++scan->skipped;
+            continue;
+        }
+
+        optparse_t options;
+        scan->pid = pid;
+        optparse_init_buffer(&options, &scan->mode, scan->window, OPTPARSE_PROC_WINDOW, scan->buf, scan->len);
+        ++scan->visited;
+        ++n;
+        if (cb(scan, &options, userdata) != 0) { break; }
+    }
+    closedir(dir);
+    return n;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // OPTPARSE_IMPLEMENTATION
+#endif  // OPTPARSE_PROC_H
@@ -0,0 +1,631 @@
+/**
+ * @file response.h
+ * @brief Response-file (@file) expansion for optparse.
+ *
+ * Build tools pass long command lines as "@args.rsp". optparse_rsp_expand()
+ * replaces every such element with the arguments stored in the file, so the
+ * resulting vector can be handed to optparse_init() and parsed like any argv.
+ *
+ * Files are mapped privately and tokenized in place: whitespace separates
+ * arguments, single and double quotes group them, and a backslash escapes the
+ * next character (the GCC/Clang convention). Tokens point into the mapping,
+ * so no argument is copied; a file must therefore not be truncated while a
+ * vector expanded from it is in use. Response files may reference further
+ * response files up to OPTPARSE_RSP_MAX_DEPTH levels; an unreadable file is
+ * kept as a literal argument.
+ *
+ * Processes that expand the same files over and over can share an
+ * optparse_rsp_cache_t: files are then read and tokenized once, and reused
+ * until their path, device, inode, modification time or size changes.
+ *
+ * Unlike optparse.h this module allocates and uses the OS file API. Include
+ * it after defining OPTPARSE_IMPLEMENTATION in the same source file that
+ * implements optparse.h.
+ *
+ * This is free and unencumbered software released into the public domain.
+ */
+#ifndef OPTPARSE_RESPONSE_H
+#define OPTPARSE_RESPONSE_H
+
+#include <stddef.h>
+
+#include "optparse.h"
+
+#ifndef OPTPARSE_RSP_MAX_DEPTH
+#define OPTPARSE_RSP_MAX_DEPTH 16
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Argument vector with response files expanded.
+ *
+ * Filled by optparse_rsp_expand() and released by optparse_rsp_free(). The
+ * strings stay valid until then; elements not taken from a response file
+ * point at the caller's original strings.
+ */
+typedef struct optparse_rsp {
+    char**                     argv;    /* expanded vector, NULL-terminated */
+    int                        argc;    /* element count of argv, excluding the terminator */
+    int                        cap;     /* internal: allocated slots in argv */
+    struct optparse__rspfile** files;   /* internal: files backing the tokens */
+    int                        nfiles;  /* internal: element count of files */
+    int                        filecap; /* internal: allocated slots in files */
+    struct optparse_rsp_cache* cache;   /* internal: cache owning the files, or NULL */
+} optparse_rsp_t;
+
+/**
+ * @brief Shared cache of tokenized response files.
+ *
+ * Entries are looked up by path and revalidated against the file's device,
+ * inode, modification time and size on every use. Least recently used entries
+ * are dropped once the cached bytes exceed the bound; entries still referenced
+ * by an optparse_rsp_t are released when that vector is freed. All functions
+ * taking a cache may be called concurrently from different threads.
+ */
+typedef struct optparse_rsp_cache optparse_rsp_cache_t;
+
+/**
+ * @brief Expand "@file" elements of @p argv; argv[0] is copied unchanged.
+ * @param rsp  vector to fill; pass rsp->argv to optparse_init()
+ * @param argv NULL-terminated argument vector (typically from main())
+ * @return 0 on success, -1 if memory could not be allocated (@p rsp is left empty)
+ */
+OPTPARSE_API int optparse_rsp_expand(optparse_rsp_t* rsp, char** argv);
+
+/**
+ * @brief Release the vector and the file mappings behind it.
+ * @param rsp vector filled by optparse_rsp_expand()
+ */
+OPTPARSE_API void optparse_rsp_free(optparse_rsp_t* rsp);
+
+/**
+ * @brief Create a response-file cache.
+ * @param max_bytes bound on file contents and token tables kept by the cache
+ * @return new cache, or NULL if memory could not be allocated
+ */
+OPTPARSE_API optparse_rsp_cache_t* optparse_rsp_cache_new(size_t max_bytes);
+
+/**
+ * @brief Destroy a cache; every vector expanded through it must be freed first.
+ * @param cache cache created by optparse_rsp_cache_new(), or NULL
+ */
+OPTPARSE_API void optparse_rsp_cache_free(optparse_rsp_cache_t* cache);
+
+/**
+ * @brief Like optparse_rsp_expand(), reusing files tokenized by earlier calls.
+ *
+ * Token strings are shared by every vector expanded from the same file
+ * version and must not be modified. The pointer array is private to @p rsp,
+ * so each thread can permute its own vector with its own optparse_t.
+ *
+ * @param rsp   vector to fill; pass rsp->argv to optparse_init()
+ * @param argv  NULL-terminated argument vector
+ * @param cache cache to look files up in and add them to
+ * @return 0 on success, -1 if memory could not be allocated (@p rsp is left empty)
+ */
+OPTPARSE_API int optparse_rsp_expand_cached(optparse_rsp_t* rsp, char** argv, optparse_rsp_cache_t* cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* ======================================================================
+ * IMPLEMENTATION
+ * ====================================================================== */
+#if defined(OPTPARSE_IMPLEMENTATION) && !defined(OPTPARSE_RESPONSE_IMPLEMENTED)
+#define OPTPARSE_RESPONSE_IMPLEMENTED
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* identity of one version of a file */
+struct optparse__rspkey {
+    unsigned long long dev;
+    unsigned long long ino;
+    unsigned long long size;
+    long long          mtime;
+    long               mtime_ns;
+};
+
+struct optparse__rspfile {
+    char*  base;   /* file contents: private mapping or heap buffer */
+    size_t size;   /* byte count of base */
+    int    mapped; /* base came from the OS mapping API */
+    char*  tail;   /* heap copy of a last token that ends the file */
+    char** tokens;
+    int    count;
+
+    /* cache bookkeeping, guarded by the cache lock */
+    struct optparse__rspfile* prev;
+    struct optparse__rspfile* next;
+    struct optparse__rspkey   key;
+    char*                     path;
+    unsigned long             hash;
+    size_t                    bytes;  /* memory charged against the cache bound */
+    int                       refs;   /* vectors currently holding this file */
+    int                       linked; /* still reachable from the cache list */
+};
+
+struct optparse_rsp_cache {
+#ifdef _WIN32
+    SRWLOCK lock;
+#else
+    pthread_mutex_t lock;
+#endif
+    struct optparse__rspfile* head; /* most recently used */
+    struct optparse__rspfile* tail; /* least recently used */
+    size_t                    bytes;
+    size_t                    max_bytes;
+};
+
+static void optparse__rsp_lock(optparse_rsp_cache_t* cache) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&cache->lock);
+#else
+    pthread_mutex_lock(&cache->lock);
+#endif
+}
+
+static void optparse__rsp_unlock(optparse_rsp_cache_t* cache) {
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&cache->lock);
+#else
+    pthread_mutex_unlock(&cache->lock);
+#endif
+}
+
+static int optparse__rsp_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/*
+ * Split [p, end) in place. Quote and escape removal only ever shrinks a
+ * token, so the compacted text and its NUL fit behind the read position; the
+ * one exception is a token running to end of file with nothing removed,
+ * which has no byte left for its terminator and is copied to f->tail.
+ */
+static int optparse__rsp_split(struct optparse__rspfile* f) {
+    char* p   = f->base;
+    char* end = f->base + f->size;
+    int   cap = 0;
+
+    for (;;) {
+        while (p < end && optparse__rsp_space(*p)) { ++p; }
+        if (p == end) { return 0; }
+
+        char* token = p;
+        char* out   = p;
+        char  quote = 0;
+        for (; p < end; ++p) {
+            const char c = *p;
+            if (c == '\\' && p + 1 < end) {
+                *out++ = *++p;
+            } else if (quote) {
+                if (c == quote) {
+                    quote = 0;
+                } else {
+                    *out++ = c;
+                }
+            } else if (c == '\'' || c == '"') {
+                quote = c;
+            } else if (optparse__rsp_space(c)) {
+                break;
+            } else {
+                *out++ = c;
+            }
+        }
+
+        if (out == end) {
+            const size_t len = (size_t)(end - token);
+            if (!(f->tail = (char*)malloc(len + 1))) { return -1; }
+            memcpy(f->tail, token, len);
+            f->tail[len] = '\0';
+            token        = f->tail;
+        } else {
+            *out = '\0';
+            if (p < end) { ++p; }
+        }
+
+        if (f->count == cap) {
+            const int nc = cap ? cap * 2 : 64;
+            char**    nt = (char**)realloc(f->tokens, (size_t)nc * sizeof(char*));
+            if (!nt) { return -1; }
+            f->tokens = nt;
+            cap       = nc;
+        }
+        f->tokens[f->count++] = token;
+    }
+}
+
+static void optparse__rsp_close(struct optparse__rspfile* f) {
+    if (f->mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(f->base);
+#else
+        munmap(f->base, f->size);
+#endif
+    } else {
+        free(f->base);
+    }
+    free(f->tail);
+    free(f->tokens);
+    free(f->path);
+    free(f);
+}
+
+#ifdef _WIN32
+static int optparse__rsp_winkey(HANDLE h, struct optparse__rspkey* key) {
+    BY_HANDLE_FILE_INFORMATION info;
+    if (!GetFileInformationByHandle(h, &info) || (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) { return 0; }
+    key->dev      = info.dwVolumeSerialNumber;
+    key->ino      = (unsigned long long)info.nFileIndexHigh << 32 | info.nFileIndexLow;
+    key->size     = (unsigned long long)info.nFileSizeHigh << 32 | info.nFileSizeLow;
+    key->mtime    = (long long)((unsigned long long)info.ftLastWriteTime.dwHighDateTime << 32 |
+                             info.ftLastWriteTime.dwLowDateTime);
+    key->mtime_ns = 0;
+    return 1;
+}
+
+static HANDLE optparse__rsp_open(const char* path) {
+    return CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+}
+#else
+static void optparse__rsp_statkey(const struct stat* st, struct optparse__rspkey* key) {
+    key->dev   = (unsigned long long)st->st_dev;
+    key->ino   = (unsigned long long)st->st_ino;
+    key->size  = (unsigned long long)st->st_size;
+    key->mtime = (long long)st->st_mtime;
+#if defined(__APPLE__)
+    key->mtime_ns = (long)st->st_mtimespec.tv_nsec;
+#elif defined(st_mtime)
+    /* st_mtime is a macro over st_mtim where the nanosecond field exists */
+    key->mtime_ns = (long)st->st_mtim.tv_nsec;
+#else
+    key->mtime_ns = 0;
+#endif
+}
+#endif
+
+/* current identity of @p path; 0 if it cannot be read */
+static int optparse__rsp_stat(const char* path, struct optparse__rspkey* key) {
+#ifdef _WIN32
+    HANDLE    h = optparse__rsp_open(path);
+    const int r = h != INVALID_HANDLE_VALUE && optparse__rsp_winkey(h, key);
+    if (h != INVALID_HANDLE_VALUE) { CloseHandle(h); }
+    return r;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0 || S_ISDIR(st.st_mode)) { return 0; }
+    optparse__rsp_statkey(&st, key);
+    return 1;
+#endif
+}
+
+/*
+ * Map @p path copy-on-write, or read it into the heap when @p copy is set or
+ * mapping fails; 0 if the file cannot be read, -1 on allocation failure.
+ */
+static int optparse__rsp_map(struct optparse__rspfile* f, const char* path, int copy) {
+#ifdef _WIN32
+    HANDLE h = optparse__rsp_open(path);
+    if (h == INVALID_HANDLE_VALUE) { return 0; }
+    if (!optparse__rsp_winkey(h, &f->key)) {
+        CloseHandle(h);
+        return 0;
+    }
+    f->size = (size_t)f->key.size;
+    if (f->size > 0) {
+        HANDLE m = copy ? NULL : CreateFileMappingA(h, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        if (m) {
+            f->base = (char*)MapViewOfFile(m, FILE_MAP_COPY, 0, 0, 0);
+            CloseHandle(m);
+        }
+        f->mapped = f->base != NULL;
+        if (!f->mapped) {
+            DWORD got = 0;
+            if (!(f->base = (char*)malloc(f->size))) {
+                CloseHandle(h);
+                return -1;
+            }
+            if (!ReadFile(h, f->base, (DWORD)f->size, &got, NULL)) { got = 0; }
+            f->size = got;
+        }
+    }
+    CloseHandle(h);
+    return 1;
+#else
+    struct stat st;
+    const int   fd = open(path, O_RDONLY);
+    if (fd < 0) { return 0; }
+    if (fstat(fd, &st) != 0 || S_ISDIR(st.st_mode)) {
+        close(fd);
+        return 0;
+    }
+    optparse__rsp_statkey(&st, &f->key);
+    f->size = (size_t)st.st_size;
+    if (f->size > 0) {
+        void* p = copy ? MAP_FAILED : mmap(NULL, f->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            f->base   = (char*)p;
+            f->mapped = 1;
+        } else {
+            size_t got = 0;
+            if (!(f->base = (char*)malloc(f->size))) {
+                close(fd);
+                return -1;
+            }
+            for (ssize_t n; got < f->size && (n = read(fd, f->base + got, f->size - got)) > 0;) { got += (size_t)n; }
+            f->size = got;
+        }
+    }
+    close(fd);
+    return 1;
+#endif
+}
+
+/* map and tokenize @p path; 0 if it cannot be read, -1 on allocation failure */
+static int optparse__rsp_load(const char* path, int copy, struct optparse__rspfile** out) {
+    struct optparse__rspfile* f = (struct optparse__rspfile*)calloc(1, sizeof(*f));
+    if (!f) { return -1; }
+    int r = optparse__rsp_map(f, path, copy);
+    if (r > 0 && optparse__rsp_split(f) != 0) { r = -1; }
+    if (r <= 0) {
+        optparse__rsp_close(f);
+        return r;
+    }
+    *out = f;
+    return 1;
+}
+
+static unsigned long optparse__rsp_hash(const char* path) {
+    unsigned long h = 2166136261u; /* FNV-1a */
+    for (; *path; ++path) { h = (h ^ (unsigned char)*path) * 16777619u; }
+    return h;
+}
+
+static int optparse__rsp_same(const struct optparse__rspkey* a, const struct optparse__rspkey* b) {
+    return a->dev == b->dev && a->ino == b->ino && a->size == b->size && a->mtime == b->mtime &&
+           a->mtime_ns == b->mtime_ns;
+}
+
+/* caller holds the lock */
+static struct optparse__rspfile* optparse__rsp_lookup(optparse_rsp_cache_t* cache, const char* path,
+                                                      unsigned long hash) {
+    struct optparse__rspfile* f = cache->head;
+    while (f && !(f->hash == hash && strcmp(f->path, path) == 0)) { f = f->next; }
+    return f;
+}
+
+/* caller holds the lock */
+static void optparse__rsp_detach(optparse_rsp_cache_t* cache, struct optparse__rspfile* f) {
+    if (f->prev) {
+        f->prev->next = f->next;
+    } else {
+        cache->head = f->next;
+    }
+    if (f->next) {
+        f->next->prev = f->prev;
+    } else {
+        cache->tail = f->prev;
+    }
+    f->prev = f->next = NULL;
+    f->linked         = 0;
+    cache->bytes -= f->bytes;
+}
+
+/* caller holds the lock; insert @p f as most recently used */
+static void optparse__rsp_link(optparse_rsp_cache_t* cache, struct optparse__rspfile* f) {
+    f->prev = NULL;
+    f->next = cache->head;
+    if (cache->head) {
+        cache->head->prev = f;
+    } else {
+        cache->tail = f;
+    }
+    cache->head = f;
+    f->linked   = 1;
+    cache->bytes += f->bytes;
+}
+
+/* caller holds the lock; drop @p f from the cache, closing it unless a vector still holds it */
+static void optparse__rsp_evict(optparse_rsp_cache_t* cache, struct optparse__rspfile* f) {
+    optparse__rsp_detach(cache, f);
+    if (f->refs == 0) { optparse__rsp_close(f); }
+}
+
+/*
+ * Fetch @p path from the cache, loading it on a miss or when the file changed
+ * since it was cached. Cached files are read into the heap rather than mapped:
+ * an entry outlives the expansion that loaded it, and truncating a file drops
+ * even the private pages of its mappings. The file is read outside the lock;
+ * if another thread cached the same version meanwhile, its copy wins.
+ */
+static int optparse__rsp_acquire(optparse_rsp_cache_t* cache, const char* path, struct optparse__rspfile** out) {
+    const unsigned long       hash = optparse__rsp_hash(path);
+    struct optparse__rspkey   key;
+    struct optparse__rspfile* f;
+    struct optparse__rspfile* old;
+
+    if (!optparse__rsp_stat(path, &key)) { return 0; }
+    optparse__rsp_lock(cache);
+    f = optparse__rsp_lookup(cache, path, hash);
+    if (f && optparse__rsp_same(&f->key, &key)) {
+        ++f->refs;
+        optparse__rsp_detach(cache, f);
+        optparse__rsp_link(cache, f);
+        optparse__rsp_unlock(cache);
+        *out = f;
+        return 1;
+    }
+    optparse__rsp_unlock(cache);
+
+    const int r = optparse__rsp_load(path, 1, &f);
+    if (r <= 0) { return r; }
+    const size_t len = strlen(path);
+    if (!(f->path = (char*)malloc(len + 1))) {
+        optparse__rsp_close(f);
+        return -1;
+    }
+    memcpy(f->path, path, len + 1);
+    f->hash  = hash;
+    f->bytes = sizeof(*f) + len + 1 + f->size + (size_t)f->count * sizeof(char*) + (f->tail ? strlen(f->tail) + 1 : 0);
+
+    optparse__rsp_lock(cache);
+    if ((old = optparse__rsp_lookup(cache, path, hash)) != NULL) {
+        if (optparse__rsp_same(&old->key, &f->key)) {
+            optparse__rsp_close(f);
+            f = old;
+            optparse__rsp_detach(cache, old);
+        } else {
+            optparse__rsp_evict(cache, old); /* stale version */
+        }
+    }
+    ++f->refs;
+    optparse__rsp_link(cache, f);
+    while (cache->bytes > cache->max_bytes) { optparse__rsp_evict(cache, cache->tail); }
+    optparse__rsp_unlock(cache);
+    *out = f;
+    return 1;
+}
+
+static void optparse__rsp_release(optparse_rsp_cache_t* cache, struct optparse__rspfile* f) {
+    if (!cache) {
+        optparse__rsp_close(f);
+        return;
+    }
+    optparse__rsp_lock(cache);
+    if (--f->refs == 0 && !f->linked) { optparse__rsp_close(f); }
+    optparse__rsp_unlock(cache);
+}
+
+static int optparse__rsp_push(optparse_rsp_t* rsp, char* arg) {
+    if (rsp->argc == rsp->cap) {
+        const int nc = rsp->cap ? rsp->cap * 2 : 64;
+        char**    nv = (char**)realloc(rsp->argv, (size_t)nc * sizeof(char*));
+        if (!nv) { return -1; }
+        rsp->argv = nv;
+        rsp->cap  = nc;
+    }
+    rsp->argv[rsp->argc++] = arg;
+    return 0;
+}
+
+/* record @p f as backing @p rsp, releasing it on failure */
+static int optparse__rsp_hold(optparse_rsp_t* rsp, struct optparse__rspfile* f) {
+    if (rsp->nfiles == rsp->filecap) {
+        const int                  nc = rsp->filecap ? rsp->filecap * 2 : 8;
+        struct optparse__rspfile** nf =
+            (struct optparse__rspfile**)realloc(rsp->files, (size_t)nc * sizeof(struct optparse__rspfile*));
+        if (!nf) {
+            optparse__rsp_release(rsp->cache, f);
+            return -1;
+        }
+        rsp->files   = nf;
+        rsp->filecap = nc;
+    }
+    rsp->files[rsp->nfiles++] = f;
+    return 0;
+}
+
+static int optparse__rsp_splice(optparse_rsp_t* rsp, char* arg, int depth) {
+    if (arg[0] == '@' && arg[1] && depth < OPTPARSE_RSP_MAX_DEPTH) {
+        struct optparse__rspfile* f = NULL;
+        const int r = rsp->cache ? optparse__rsp_acquire(rsp->cache, arg + 1, &f) : optparse__rsp_load(arg + 1, 0, &f);
+        if (r < 0) { return -1; }
+        if (r > 0) {
+            if (optparse__rsp_hold(rsp, f) != 0) { return -1; }
+            for (int k = 0; k < f->count; ++k) {
+                if (optparse__rsp_splice(rsp, f->tokens[k], depth + 1) != 0) { return -1; }
+            }
+            return 0;
+        }
+    }
+    return optparse__rsp_push(rsp, arg);
+}
+
+OPTPARSE_API void optparse_rsp_free(optparse_rsp_t* rsp) {
+    for (int k = 0; k < rsp->nfiles; ++k) { optparse__rsp_release(rsp->cache, rsp->files[k]); }
+    free(rsp->files);
+    free(rsp->argv);
+    rsp->argv    = NULL;
+    rsp->argc    = 0;
+    rsp->cap     = 0;
+    rsp->files   = NULL;
+    rsp->nfiles  = 0;
+    rsp->filecap = 0;
+}
+
+OPTPARSE_API int optparse_rsp_expand_cached(optparse_rsp_t* rsp, char** argv, optparse_rsp_cache_t* cache) {
+    rsp->argv    = NULL;
+    rsp->argc    = 0;
+    rsp->cap     = 0;
+    rsp->files   = NULL;
+    rsp->nfiles  = 0;
+    rsp->filecap = 0;
+    rsp->cache   = cache;
+
+    int ok = 1;
+    for (int i = 0; ok && argv[i]; ++i) {
+        ok = (i == 0 ? optparse__rsp_push(rsp, argv[0]) : optparse__rsp_splice(rsp, argv[i], 0)) == 0;
+    }
+    if (!ok || optparse__rsp_push(rsp, NULL) != 0) {
+        optparse_rsp_free(rsp);
+        return -1;
+    }
+    --rsp->argc; /* the terminator is not counted */
+    return 0;
+}
+
+OPTPARSE_API int optparse_rsp_expand(optparse_rsp_t* rsp, char** argv) {
+    return optparse_rsp_expand_cached(rsp, argv, NULL);
+}
+
+OPTPARSE_API optparse_rsp_cache_t* optparse_rsp_cache_new(size_t max_bytes) {
+    optparse_rsp_cache_t* cache = (optparse_rsp_cache_t*)calloc(1, sizeof(*cache));
+    if (!cache) { return NULL; }
+#ifdef _WIN32
+    InitializeSRWLock(&cache->lock);
+#else
+    if (pthread_mutex_init(&cache->lock, NULL) != 0) {
+        free(cache);
+        return NULL;
+    }
+#endif
+    cache->max_bytes = max_bytes;
+    return cache;
+}
+
+OPTPARSE_API void optparse_rsp_cache_free(optparse_rsp_cache_t* cache) {
+    if (!cache) { return; }
+    while (cache->head) { optparse__rsp_evict(cache, cache->head); }
+#ifndef _WIN32
+    pthread_mutex_destroy(&cache->lock);
+#endif
+    free(cache);
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // OPTPARSE_IMPLEMENTATION
+#endif  // OPTPARSE_RESPONSE_H
@@ -0,0 +1,161 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+static const optparse_long_t kAbbrevLongopts[] = {
+    {"verbose", 'v', OPTPARSE_NONE},
+    {"version", 'V', OPTPARSE_NONE},
+    {"output", 'o', OPTPARSE_REQUIRED},
+    {"out", 256, OPTPARSE_NONE},
+    {"color", 'c', OPTPARSE_OPTIONAL},
+    {"colour", 'c', OPTPARSE_OPTIONAL},
+    {"dry-run", 'n', OPTPARSE_NONE},
+    {"dry-run", 'n', OPTPARSE_NONE},
+    {nullptr, 'q', OPTPARSE_NONE},
+    {nullptr, 0, OPTPARSE_NONE},
+};
+
+struct abbrev_result {
+    int         r;
+    int         longindex;
+    std::string optarg;
+    std::string errmsg;
+};
+
+static abbrev_result abbrev_one(const optparse_index_t* index, const char* arg) {
+    char*      argv[] = {(char*)"prog", (char*)arg, (char*)"x", nullptr};
+    optparse_t o;
+    int        li = -2;
+    optparse_init(&o, argv);
+    const int r = optparse_long_abbrev(&o, index, &li);
+    return {r, li, o.optarg ? o.optarg : "<null>", o.errmsg};
+}
+
+TEST_CASE("abbrev: unique prefixes select their option", "[abbrev]") {
+    int              order[16];
+    optparse_index_t index;
+    REQUIRE(optparse_index_init(&index, kAbbrevLongopts, order, 16) == 8);
+
+    REQUIRE(abbrev_one(&index, "--verb").longindex == 0);
+    REQUIRE(abbrev_one(&index, "--vers").longindex == 1);
+    REQUIRE(abbrev_one(&index, "--dr").r == 'n');
+    REQUIRE(abbrev_one(&index, "--dr").longindex == 6); /* identical names are aliases too */
+
+    /* an exact name wins over the longer names it abbreviates */
+    REQUIRE(abbrev_one(&index, "--out").r == 256);
+    REQUIRE(abbrev_one(&index, "--outp").r == 'o');
+    REQUIRE(abbrev_one(&index, "--outp").optarg == "x");
+    REQUIRE(abbrev_one(&index, "--outp=f").optarg == "f");
+
+    /* aliases: same shortname and argtype, so the first one is taken */
+    REQUIRE(abbrev_one(&index, "--col").r == 'c');
+    REQUIRE(abbrev_one(&index, "--col").longindex == 4);
+    REQUIRE(abbrev_one(&index, "--colo=red").optarg == "red");
+
+    REQUIRE(abbrev_one(&index, "--verbosee").errmsg == "invalid option -- 'verbosee'");
+    REQUIRE(abbrev_one(&index, "--x").errmsg == "invalid option -- 'x'");
+    REQUIRE(abbrev_one(&index, "--=v").errmsg == "invalid option -- '=v'");
+    REQUIRE(abbrev_one(&index, "--verb=1").errmsg == "option takes no arguments -- 'verbose'");
+}
+
+TEST_CASE("abbrev: ambiguous prefixes list their candidates", "[abbrev]") {
+    int              order[16];
+    optparse_index_t index;
+    optparse_index_init(&index, kAbbrevLongopts, order, 16);
+
+    abbrev_result res = abbrev_one(&index, "--ver");
+    REQUIRE(res.r == '?');
+    REQUIRE(res.longindex == -2); /* left as it was, like for unknown options */
+    REQUIRE(res.errmsg == "ambiguous option -- 'ver' (verbose, version)");
+    REQUIRE(abbrev_one(&index, "--v=1").errmsg == "ambiguous option -- 'v' (verbose, version)");
+    REQUIRE(abbrev_one(&index, "--ou").errmsg == "ambiguous option -- 'ou' (out, output)");
+
+    /* optparse_long_indexed() never accepts prefixes */
+    char*      argv[] = {(char*)"prog", (char*)"--verb", nullptr};
+    optparse_t o;
+    optparse_init(&o, argv);
+    REQUIRE(optparse_long_indexed(&o, &index, nullptr) == '?');
+    REQUIRE(std::string(o.errmsg) == "invalid option -- 'verb'");
+}
+
+TEST_CASE("abbrev: long candidate lists", "[abbrev][arena]") {
+    std::vector<std::string> names;
+    for (int k = 0; k < 12; ++k) { names.push_back("common-prefix-" + std::to_string(k)); }
+    std::vector<optparse_long_t> lo;
+    for (auto& n : names) { lo.push_back({n.c_str(), 0, OPTPARSE_NONE}); }
+    lo.push_back({nullptr, 0, OPTPARSE_NONE});
+    std::vector<int> order(names.size());
+    optparse_index_t index;
+    optparse_index_init(&index, lo.data(), order.data(), (int)order.size());
+
+    char*      argv[] = {(char*)"prog", (char*)"--common-prefix-1", (char*)"--comm", nullptr};
+    optparse_t o;
+    optparse_init(&o, argv);
+    REQUIRE(optparse_long_abbrev(&o, &index, nullptr) == 0); /* exact, though "common-prefix-10" extends it */
+    REQUIRE(optparse_long_abbrev(&o, &index, nullptr) == '?');
+    REQUIRE(std::string(o.errmsg).size() == 63);
+
+    alignas(16) char mem[512];
+    optparse_arena_t arena;
+    optparse_arena_init(&arena, mem, sizeof(mem));
+    const std::string full = optparse_arena_error(&arena, &o);
+    REQUIRE(full.compare(0, 63, o.errmsg) == 0);
+    REQUIRE(full == "ambiguous option -- 'comm' (common-prefix-0, common-prefix-1, common-prefix-10, "
+                    "common-prefix-11, common-prefix-2, common-prefix-3, common-prefix-4, common-prefix-5, "
+                    "common-prefix-6, common-prefix-7, common-prefix-8, common-prefix-9)");
+}
+
+/* reference: exact match, else the prefix rule spelled out over the whole table */
+static int abbrev_reference(const std::vector<std::string>& names, const std::string& option) {
+    const std::string name = option.substr(0, option.find('='));
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) { return (int)i; }
+    }
+    int found = -1;
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (name.empty() || names[i].compare(0, name.size(), name) != 0) { continue; }
+        if (found >= 0) { return -2; }
+        found = (int)i;
+    }
+    return found;
+}
+
+TEST_CASE("abbrev: random prefixes against a reference", "[abbrev]") {
+    std::vector<std::string> names;
+    std::mt19937             rng(23);
+    for (int k = 0; k < 60; ++k) {
+        std::string n;
+        for (int len = 1 + (int)(rng() % 8); len > 0; --len) { n += (char)('a' + rng() % 3); }
+        bool dup = false;
+        for (auto& m : names) { dup = dup || m == n; }
+        if (!dup) { names.push_back(n); }
+    }
+    std::vector<optparse_long_t> lo;
+    for (auto& n : names) { lo.push_back({n.c_str(), 0, OPTPARSE_OPTIONAL}); }
+    lo.push_back({nullptr, 0, OPTPARSE_NONE});
+    std::vector<int> order(names.size());
+    optparse_index_t index;
+    optparse_index_init(&index, lo.data(), order.data(), (int)order.size());
+
+    for (int iter = 0; iter < 5000; ++iter) {
+        std::string option;
+        for (int len = 1 + (int)(rng() % 9); len > 0; --len) { option += (char)('a' + rng() % 3); }
+        if (rng() % 2) { option += "=v"; }
+        const std::string   arg = "--" + option;
+        const abbrev_result res = abbrev_one(&index, arg.c_str());
+        const int           ref = abbrev_reference(names, option);
+        if (ref >= 0) {
+            REQUIRE(res.longindex == ref);
+        } else {
+            REQUIRE(res.r == '?');
+            const std::string want = ref == -2 ? OPTPARSE_MSG_AMBIGUOUS : OPTPARSE_MSG_INVALID;
+            REQUIRE(res.errmsg.compare(0, want.size(), want) == 0);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+static const optparse_long_t kArenaLongopts[] = {
+    {"include", 'I', OPTPARSE_REQUIRED},
+    {"json", 'j', OPTPARSE_NONE},
+    {nullptr, 0, OPTPARSE_NONE},
+};
+
+TEST_CASE("arena: split, collect and reset per request", "[arena]") {
+    alignas(16) char mem[1024];
+    optparse_arena_t arena;
+    optparse_arena_init(&arena, mem, sizeof(mem));
+
+    for (int request = 0; request < 3; ++request) {
+        char**          argv     = nullptr;
+        optparse_list_t includes = {};
+        optparse_list_t rest     = {};
+        optparse_t      o;
+
+        REQUIRE(optparse_arena_split(&arena, "get -I a 'x y' --include=b -j -I c z", &argv) == 9);
+        REQUIRE(argv != nullptr);
+        optparse_init(&o, argv);
+        for (int r; (r = optparse_long(&o, kArenaLongopts, nullptr)) != -1;) {
+            REQUIRE(r != '?');
+            if (r == 'I') { REQUIRE(optparse_arena_append(&arena, &includes, o.optarg) == 0); }
+        }
+        for (char* a; (a = optparse_arg(&o)) != nullptr;) { REQUIRE(optparse_arena_append(&arena, &rest, a) == 0); }
+
+        REQUIRE(includes.count == 3);
+        REQUIRE(std::string(includes.items[2]) == "c");
+        REQUIRE(includes.items[3] == nullptr);
+        REQUIRE(rest.count == 2);
+        REQUIRE(std::string(rest.items[0]) == "x y");
+
+        /* every request starts from the same memory */
+        REQUIRE(argv[0] >= mem);
+        REQUIRE(argv[0] < mem + 64);
+        optparse_arena_reset(&arena);
+        REQUIRE(arena.used == 0);
+    }
+}
+
+TEST_CASE("arena: list grows in place while it is the last allocation", "[arena]") {
+    alignas(16) char mem[4096];
+    optparse_arena_t arena;
+    optparse_list_t  list   = {};
+    char             item[] = "v";
+    optparse_arena_init(&arena, mem, sizeof(mem));
+
+    for (int k = 0; k < 100; ++k) { REQUIRE(optparse_arena_append(&arena, &list, item) == 0); }
+    REQUIRE(list.count == 100);
+    REQUIRE(arena.used == (size_t)list.cap * sizeof(char*));
+
+    /* another allocation on top forces the next growth to move the list */
+    REQUIRE(optparse_arena_alloc(&arena, 1) != nullptr);
+    for (int k = 0; k < 100; ++k) { REQUIRE(optparse_arena_append(&arena, &list, item) == 0); }
+    REQUIRE(list.count == 200);
+    for (int k = 0; k < 200; ++k) { REQUIRE(list.items[k] == item); }
+}
+
+TEST_CASE("arena: exhaustion fails cleanly", "[arena][error]") {
+    alignas(16) char mem[48];
+    optparse_arena_t arena;
+    char**           argv = nullptr;
+    optparse_arena_init(&arena, mem, sizeof(mem));
+
+    REQUIRE(optparse_arena_split(&arena, "a b c d e f g h i j k", &argv) == -1);
+    REQUIRE(arena.used == 0);
+    REQUIRE(optparse_arena_split(&arena, "a 'b", &argv) == -2);
+    REQUIRE(arena.used == 0);
+    REQUIRE(optparse_arena_split(&arena, "a b", &argv) == 2);
+    REQUIRE(argv != nullptr);
+    REQUIRE(optparse_arena_alloc(&arena, sizeof(mem)) == nullptr);
+
+    optparse_arena_t none;
+    optparse_arena_init(&none, nullptr, 0);
+    REQUIRE(optparse_arena_alloc(&none, 1) == nullptr);
+    REQUIRE(optparse_arena_split(&none, "", &argv) == -1);
+}
+
+TEST_CASE("arena: full error message", "[arena][error]") {
+    alignas(16) char  mem[512];
+    optparse_arena_t  arena;
+    optparse_t        o;
+    const std::string longname = "--" + std::string(100, 'x');
+    std::vector<char> text(longname.begin(), longname.end());
+    text.push_back('\0');
+    char* argv[] = {const_cast<char*>("prog"), text.data(), const_cast<char*>("-z"), const_cast<char*>("-I"),
+                    nullptr};
+    optparse_arena_init(&arena, mem, sizeof(mem));
+    optparse_init(&o, argv);
+
+    REQUIRE(optparse_arena_error(&arena, &o) == nullptr);
+    REQUIRE(optparse_long(&o, kArenaLongopts, nullptr) == '?');
+    const std::string full = optparse_arena_error(&arena, &o);
+    REQUIRE(full == "invalid option -- '" + longname.substr(2) + "'");
+    REQUIRE(std::string(o.errmsg).size() == 63); /* cut, then closed with a quote */
+    REQUIRE(full.compare(0, 62, o.errmsg, 62) == 0);
+
+    REQUIRE(optparse_long(&o, kArenaLongopts, nullptr) == '?');
+    REQUIRE(std::string(optparse_arena_error(&arena, &o)) == o.errmsg);
+    REQUIRE(std::string(o.errmsg) == "invalid option -- 'z'");
+    REQUIRE(optparse_long(&o, kArenaLongopts, nullptr) == '?');
+    REQUIRE(std::string(optparse_arena_error(&arena, &o)) == "option requires an argument -- 'I'");
+}
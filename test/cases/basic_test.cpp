@@ -152,6 +152,49 @@ TEST_CASE("short: errmsg is empty on success", "[short]") {
     REQUIRE(o.errmsg[0] == '\0');
 }
 
+TEST_CASE("compiled: table matches optstring semantics", "[compiled]") {
+    optparse_shortopts_t tab;
+    optparse_compile_short(&tab, "ab:c::a:");
+    REQUIRE(tab.argtype['a'] == OPTPARSE_NONE); /* first occurrence wins */
+    REQUIRE(tab.argtype['b'] == OPTPARSE_REQUIRED);
+    REQUIRE(tab.argtype['c'] == OPTPARSE_OPTIONAL);
+    REQUIRE(tab.argtype[':'] == -1);
+    REQUIRE(tab.argtype['z'] == -1);
+}
+
+TEST_CASE("compiled: same results as optparse()", "[compiled]") {
+    const char* optstring = "ab:c::vx";
+    Argv        av1{"-vvx", "foo", "-bval", "-c", "-cinline", "--", "-a"};
+    Argv        av2{"-vvx", "foo", "-bval", "-c", "-cinline", "--", "-a"};
+    auto        o1 = av1.to_opts();
+    auto        o2 = av2.to_opts();
+
+    optparse_shortopts_t tab;
+    optparse_compile_short(&tab, optstring);
+
+    int r1, r2;
+    do {
+        r1 = optparse(&o1, optstring);
+        r2 = optparse_short(&o2, &tab);
+        REQUIRE(r1 == r2);
+        REQUIRE(o1.optind == o2.optind);
+        REQUIRE(o1.optarg == o2.optarg);
+    } while (r1 != -1);
+    REQUIRE(unconsumed_args(&o1) == unconsumed_args(&o2));
+}
+
+TEST_CASE("compiled: errors match optparse()", "[compiled][error]") {
+    optparse_shortopts_t tab;
+    optparse_compile_short(&tab, "c:");
+
+    Argv av{"-z", "-c"};
+    auto o = av.to_opts();
+    REQUIRE(optparse_short(&o, &tab) == '?');
+    REQUIRE(std::string(o.errmsg).find(OPTPARSE_MSG_INVALID) == 0);
+    REQUIRE(optparse_short(&o, &tab) == '?');
+    REQUIRE(std::string(o.errmsg).find(OPTPARSE_MSG_MISSING) == 0);
+}
+
 TEST_CASE("long: single flag --amend", "[long]") {
     Argv av{"--amend"};
     auto o  = av.to_opts();
@@ -318,6 +361,88 @@ TEST_CASE("posix: stop at first non-option", "[posix]") {
     REQUIRE(args[0] == "stop");
 }
 
+TEST_CASE("record: argv is never written", "[record]") {
+    Argv                av{"foo", "--delay", "1234", "bar", "-cred", "--", "-a"};
+    std::vector<char*>  before(av.data(), av.data() + 9);
+    auto                o = av.to_opts();
+    optparse_mode_t     mode;
+    int                 pos[8];
+    std::vector<int>    seen;
+    optparse_record(&o, &mode, pos, 8);
+
+    int c;
+    while ((c = optparse_long(&o, kLongopts, nullptr)) != -1) { seen.push_back(c); }
+    REQUIRE(seen == std::vector<int>{'d', 'c'});
+    REQUIRE(std::vector<char*>(av.data(), av.data() + 9) == before);
+    REQUIRE(o.optind == 7); /* scan position, just past "--" */
+
+    auto args     = unconsumed_args(&o);
+    auto expected = std::vector<std::string>{"foo", "bar", "-a"};
+    REQUIRE(args == expected);
+}
+
+TEST_CASE("record: full position list reports an error", "[record][error]") {
+    Argv            av{"a", "b", "-e", "c", "-b", "d"};
+    auto            o = av.to_opts();
+    optparse_mode_t mode;
+    int             pos[2];
+    optparse_record(&o, &mode, pos, 2);
+
+    REQUIRE(optparse_long(&o, kLongopts, nullptr) == 'e');
+    REQUIRE(optparse_long(&o, kLongopts, nullptr) == '?');
+    REQUIRE(std::string(o.errmsg).find(OPTPARSE_MSG_NOSPACE) == 0);
+    REQUIRE(std::string(o.argv[o.optind]) == "c");
+
+    /* draining the recorded positions frees the list and keeps the order */
+    REQUIRE(std::string(optparse_arg(&o)) == "a");
+    REQUIRE(std::string(optparse_arg(&o)) == "b");
+    REQUIRE(optparse_long(&o, kLongopts, nullptr) == 'b');
+    REQUIRE(optparse_long(&o, kLongopts, nullptr) == -1);
+    auto args     = unconsumed_args(&o);
+    auto expected = std::vector<std::string>{"c", "d"};
+    REQUIRE(args == expected);
+}
+
+TEST_CASE("inorder: non-options returned as option 1", "[inorder]") {
+    Argv               av{"file1", "-e", "file2", "--delay=5", "file3", "--", "-a", "file4"};
+    std::vector<char*> before(av.data(), av.data() + 10);
+    auto               o = av.to_opts();
+    o.permute            = OPTPARSE_RETURN_IN_ORDER;
+
+    std::vector<std::string> events;
+    int                      c, li;
+    while ((c = optparse_long(&o, kLongopts, &li)) != -1) {
+        if (c == 1) {
+            REQUIRE(li == -1);
+            events.push_back(o.optarg);
+        } else {
+            events.push_back(std::string(1, (char)c));
+        }
+    }
+    auto expected = std::vector<std::string>{"file1", "e", "file2", "d", "file3"};
+    REQUIRE(events == expected);
+    REQUIRE(std::vector<char*>(av.data(), av.data() + 10) == before);
+
+    /* "--" still ends option processing; the rest is left for optparse_arg() */
+    auto args = unconsumed_args(&o);
+    REQUIRE(args == std::vector<std::string>{"-a", "file4"});
+}
+
+TEST_CASE("inorder: works with short option strings", "[inorder]") {
+    Argv av{"a", "-xy", "b"};
+    auto o    = av.to_opts();
+    o.permute = OPTPARSE_RETURN_IN_ORDER;
+    REQUIRE(optparse(&o, "xy") == 1);
+    REQUIRE(std::string(o.optarg) == "a");
+    REQUIRE(optparse(&o, "xy") == 'x');
+    REQUIRE(o.optarg == nullptr);
+    REQUIRE(optparse(&o, "xy") == 'y');
+    REQUIRE(optparse(&o, "xy") == 1);
+    REQUIRE(std::string(o.optarg) == "b");
+    REQUIRE(optparse(&o, "xy") == -1);
+    REQUIRE(optparse_arg(&o) == nullptr);
+}
+
 TEST_CASE("arg: basic positional collection", "[arg]") {
     Argv av{"-a", "foo", "bar"};
     auto o = av.to_opts();
@@ -350,6 +475,18 @@ TEST_CASE("arg: step over subcommand and re-parse", "[arg]") {
     REQUIRE(optparse_long(&o, kLongopts, nullptr) == -1);
 }
 
+TEST_CASE("arg: pop pending positionals mid-parse", "[arg][permute]") {
+    Argv av{"foo", "--amend", "bar", "baz", "--brief", "qux"};
+    auto o = av.to_opts();
+    REQUIRE(optparse_long(&o, kLongopts, nullptr) == 'a');
+    REQUIRE(std::string(optparse_arg(&o)) == "foo");
+    REQUIRE(optparse_long(&o, kLongopts, nullptr) == 'b');
+    REQUIRE(optparse_long(&o, kLongopts, nullptr) == -1);
+    auto args     = unconsumed_args(&o);
+    auto expected = std::vector<std::string>{"bar", "baz", "qux"};
+    REQUIRE(args == expected);
+}
+
 TEST_CASE("arg: returns NULL when exhausted", "[arg]") {
     Argv av{};
     auto o = av.to_opts();
@@ -0,0 +1,136 @@
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "optparse/batch.h"
+
+static const optparse_long_t kPoolLongopts[] = {
+    {"amend", 'a', OPTPARSE_NONE},
+    {"delay", 'd', OPTPARSE_REQUIRED},
+    {nullptr, 0, OPTPARSE_NONE},
+};
+
+/* per-line result slot; each line is written by exactly one thread */
+struct BatchSlot {
+    int         amend = 0;
+    std::string delay;
+    int         positionals = 0;
+    int         errors      = 0;
+    int         visits      = 0;
+};
+
+static void parse_line(optparse_t* options, BatchSlot& slot) {
+    ++slot.visits;
+    for (int r; (r = optparse_long(options, kPoolLongopts, nullptr)) != -1;) {
+        switch (r) {
+            case 'a': ++slot.amend; break;
+            case 'd': slot.delay = options->optarg; break;
+            case 1: ++slot.positionals; break;
+            case '?': ++slot.errors; break;
+        }
+    }
+    while (optparse_arg(options)) { ++slot.positionals; }
+}
+
+static int batch_visit(optparse_t* options, int line, void* userdata) {
+    parse_line(options, (*static_cast<std::vector<BatchSlot>*>(userdata))[line]);
+    return 0;
+}
+
+static std::vector<std::string> line_args(int i) {
+    std::vector<std::string> args = {"prog"};
+    for (int k = 0; k < i % 7; ++k) { args.push_back("-a"); }
+    args.push_back("file" + std::to_string(i));
+    args.push_back("--delay=" + std::to_string(i));
+    if (i % 11 == 0) { args.push_back("--bogus"); }
+    return args;
+}
+
+TEST_CASE("batch pool: every argv parsed exactly once", "[batch][pool]") {
+    const int                             n = 5000;
+    std::vector<std::vector<std::string>> storage;
+    std::vector<std::vector<char*>>       ptrs(n);
+    std::vector<char**>                   argvs;
+    for (int i = 0; i < n; ++i) { storage.push_back(line_args(i)); }
+    for (int i = 0; i < n; ++i) {
+        for (auto& s : storage[i]) { ptrs[i].push_back(&s[0]); }
+        ptrs[i].push_back(nullptr);
+        argvs.push_back(ptrs[i].data());
+    }
+
+    for (int threads : {1, 3, 8, 0}) {
+        std::vector<BatchSlot> slots(n);
+        /* restore the order permuted by the previous round */
+        for (int i = 0; i < n; ++i) {
+            for (size_t k = 0; k < storage[i].size(); ++k) { ptrs[i][k] = &storage[i][k][0]; }
+        }
+        REQUIRE(optparse_batch_argv(argvs.data(), n, threads, batch_visit, &slots) == 0);
+        for (int i = 0; i < n; ++i) {
+            REQUIRE(slots[i].visits == 1);
+            REQUIRE(slots[i].amend == i % 7);
+            REQUIRE(slots[i].delay == std::to_string(i));
+            REQUIRE(slots[i].positionals == 1);
+            REQUIRE(slots[i].errors == (i % 11 == 0));
+        }
+    }
+    REQUIRE(optparse_batch_argv(argvs.data(), 0, 4, batch_visit, nullptr) == 0);
+}
+
+TEST_CASE("batch pool: blobs match argv results", "[batch][pool]") {
+    const int                n = 3000;
+    std::vector<std::string> blobs;
+    for (int i = 0; i < n; ++i) {
+        std::string blob;
+        for (const auto& a : line_args(i)) { blob.append(a).push_back('\0'); }
+        blobs.push_back(blob);
+    }
+    std::vector<char*>  bufs;
+    std::vector<size_t> lens;
+    for (auto& b : blobs) {
+        bufs.push_back(&b[0]);
+        lens.push_back(b.size());
+    }
+
+    std::vector<BatchSlot> slots(n);
+    REQUIRE(optparse_batch_blobs(bufs.data(), lens.data(), n, 4, batch_visit, &slots) == 0);
+    for (int i = 0; i < n; ++i) {
+        REQUIRE(slots[i].visits == 1);
+        REQUIRE(slots[i].amend == i % 7);
+        REQUIRE(slots[i].delay == std::to_string(i));
+        REQUIRE(slots[i].positionals == 1);
+    }
+}
+
+struct BatchStop {
+    std::atomic<int> visited{0};
+    int              stop_at;
+};
+
+static int batch_stop(optparse_t*, int line, void* userdata) {
+    BatchStop* s = static_cast<BatchStop*>(userdata);
+    ++s->visited;
+    return line == s->stop_at ? 42 : 0;
+}
+
+TEST_CASE("batch pool: callback stops the batch", "[batch][pool]") {
+    const int           n = 100000;
+    std::string         blob("prog\0-a\0", 8);
+    std::vector<char*>  bufs(n, &blob[0]);
+    std::vector<size_t> lens(n, blob.size());
+
+    BatchStop s;
+    s.stop_at = 10;
+    REQUIRE(optparse_batch_blobs(bufs.data(), lens.data(), n, 4, batch_stop, &s) == 42);
+    REQUIRE(s.visited < n);
+
+    /* blobs are only read, so the same one can back every line */
+    s.visited = 0;
+    s.stop_at = -1;
+    REQUIRE(optparse_batch_blobs(bufs.data(), lens.data(), n, 4, batch_stop, &s) == 0);
+    REQUIRE(s.visited == n);
+}
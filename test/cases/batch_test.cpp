@@ -0,0 +1,117 @@
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+static const optparse_long_t kBatchLongopts[] = {
+    {"amend", 'a', OPTPARSE_NONE},     {"brief", 'b', OPTPARSE_NONE}, {"color", 'c', OPTPARSE_OPTIONAL},
+    {"delay", 'd', OPTPARSE_REQUIRED}, {"erase", 'e', OPTPARSE_NONE}, {"long-only", 300, OPTPARSE_NONE},
+    {nullptr, 0, OPTPARSE_NONE},
+};
+
+static std::vector<char*> make_argv(std::initializer_list<const char*> args) {
+    std::vector<char*> v;
+    v.push_back(const_cast<char*>("prog"));
+    for (auto a : args) { v.push_back(const_cast<char*>(a)); }
+    v.push_back(nullptr);
+    return v;
+}
+
+TEST_CASE("batch: events match optparse_long()", "[batch]") {
+    auto argv1 = make_argv({"foo", "-ab", "--delay", "10", "bar", "-cblue", "--long-only", "--", "-e"});
+    auto argv2 = argv1;
+
+    optparse_t o1, o2;
+    optparse_init(&o1, argv1.data());
+    optparse_init(&o2, argv2.data());
+
+    optparse_event_t events[16];
+    const int        n = optparse_long_all(&o1, kBatchLongopts, events, 16);
+    REQUIRE(n == 5);
+
+    for (int k = 0; k < n; ++k) {
+        int li = -1;
+        REQUIRE(optparse_long(&o2, kBatchLongopts, &li) == events[k].option);
+        REQUIRE(li == events[k].longindex);
+        REQUIRE(o2.optarg == events[k].optarg);
+    }
+    REQUIRE(optparse_long(&o2, kBatchLongopts, nullptr) == -1);
+    REQUIRE(o1.optind == o2.optind);
+    REQUIRE(argv1 == argv2);
+}
+
+TEST_CASE("batch: argind and positional list in record mode", "[batch][record]") {
+    auto               argv   = make_argv({"foo", "-ab", "--delay", "10", "bar", "-cblue"});
+    auto               before = argv;
+    optparse_t         o;
+    optparse_mode_t    mode;
+    int                pos[4];
+    optparse_event_t   events[8];
+    std::vector<char*> args;
+
+    optparse_init(&o, argv.data());
+    optparse_record(&o, &mode, pos, 4);
+    const int n = optparse_long_all(&o, kBatchLongopts, events, 8);
+    REQUIRE(n == 4);
+    REQUIRE(argv == before);
+
+    const int expect_opt[] = {'a', 'b', 'd', 'c'};
+    const int expect_ind[] = {2, 2, 3, 6};
+    for (int k = 0; k < n; ++k) {
+        REQUIRE(events[k].option == expect_opt[k]);
+        REQUIRE(events[k].argind == expect_ind[k]);
+    }
+    REQUIRE(std::string(events[2].optarg) == "10");
+    REQUIRE(std::string(events[3].optarg) == "blue");
+
+    for (char* a = optparse_arg(&o); a; a = optparse_arg(&o)) { args.push_back(a); }
+    REQUIRE(args == std::vector<char*>{argv[1], argv[5]});
+}
+
+TEST_CASE("batch: stops after the first error", "[batch][error]") {
+    auto             argv = make_argv({"-a", "--bogus", "-b"});
+    optparse_t       o;
+    optparse_event_t events[8];
+
+    optparse_init(&o, argv.data());
+    REQUIRE(optparse_long_all(&o, kBatchLongopts, events, 8) == 2);
+    REQUIRE(events[1].option == '?');
+    REQUIRE(events[1].argind == 2);
+    REQUIRE(std::string(o.errmsg).find("bogus") != std::string::npos);
+
+    /* the caller may resume after inspecting the error */
+    REQUIRE(optparse_long_all(&o, kBatchLongopts, events, 8) == 1);
+    REQUIRE(events[0].option == 'b');
+}
+
+TEST_CASE("batch: resumes when capacity is exhausted", "[batch]") {
+    auto             argv = make_argv({"-e", "-e", "-e", "-e", "-e"});
+    optparse_t       o;
+    optparse_event_t events[2];
+    int              total = 0, n;
+
+    optparse_init(&o, argv.data());
+    while ((n = optparse_long_all(&o, kBatchLongopts, events, 2)) > 0) { total += n; }
+    REQUIRE(total == 5);
+}
+
+TEST_CASE("batch: in-order mode reports non-options as events", "[batch][inorder]") {
+    auto             argv = make_argv({"x", "-a", "y"});
+    optparse_t       o;
+    optparse_event_t events[4];
+
+    optparse_init(&o, argv.data());
+    o.permute = OPTPARSE_RETURN_IN_ORDER;
+    REQUIRE(optparse_long_all(&o, kBatchLongopts, events, 4) == 3);
+    REQUIRE(events[0].option == 1);
+    REQUIRE(events[0].argind == 1);
+    REQUIRE(events[0].longindex == -1);
+    REQUIRE(std::string(events[0].optarg) == "x");
+    REQUIRE(events[1].option == 'a');
+    REQUIRE(events[2].option == 1);
+    REQUIRE(events[2].argind == 3);
+}
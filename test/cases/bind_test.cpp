@@ -0,0 +1,122 @@
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+enum { BIND_VERBOSE, BIND_OUTPUT, BIND_QUIET, BIND_INCLUDE, BIND_JOBS, BIND_COLOR, BIND_HELP, BIND_COUNT };
+
+static const optparse_long_t kBindLongopts[] = {
+    {"verbose", 'v', OPTPARSE_NONE},
+    {"output", 'o', OPTPARSE_REQUIRED},
+    {"quiet", 'q', OPTPARSE_NONE},
+    {"include", 'I', OPTPARSE_REQUIRED},
+    {"jobs", 'j', OPTPARSE_REQUIRED},
+    {"color", 0, OPTPARSE_OPTIONAL},
+    {"help", 'h', OPTPARSE_NONE},
+    {nullptr, 0, OPTPARSE_NONE},
+};
+
+struct bind_config {
+    int             verbose  = 0;
+    int             quiet    = 0;
+    char*           output   = nullptr;
+    char*           color    = (char*)"auto";
+    long            jobs     = 1;
+    optparse_list_t includes = {};
+};
+
+static void bind_setup(bind_config* c, optparse_bind_t* binds) {
+    binds[BIND_VERBOSE] = {OPTPARSE_BIND_COUNT, &c->verbose};
+    binds[BIND_OUTPUT]  = {OPTPARSE_BIND_STRING, &c->output};
+    binds[BIND_QUIET]   = {OPTPARSE_BIND_FLAG, &c->quiet};
+    binds[BIND_INCLUDE] = {OPTPARSE_BIND_APPEND, &c->includes};
+    binds[BIND_JOBS]    = {OPTPARSE_BIND_INT, &c->jobs};
+    binds[BIND_COLOR]   = {OPTPARSE_BIND_STRING, &c->color};
+    binds[BIND_HELP]    = {OPTPARSE_BIND_NONE, nullptr};
+}
+
+TEST_CASE("bind: one call fills the caller's struct", "[bind]") {
+    char* argv[] = {(char*)"prog", (char*)"-vv", (char*)"--output=f", (char*)"a", (char*)"-Ix", (char*)"-I",
+                    (char*)"y", (char*)"--jobs", (char*)"-12", (char*)"--verbose", (char*)"-q", (char*)"--color",
+                    (char*)"--help", (char*)"--include=z", nullptr};
+    bind_config     c;
+    optparse_bind_t binds[BIND_COUNT];
+    bind_setup(&c, binds);
+
+    alignas(16) char mem[256];
+    optparse_arena_t arena;
+    optparse_arena_init(&arena, mem, sizeof(mem));
+
+    optparse_t o;
+    optparse_init(&o, argv);
+    REQUIRE(optparse_long_bind(&o, kBindLongopts, binds, &arena) == BIND_HELP);
+    REQUIRE(c.verbose == 3);
+    REQUIRE(c.quiet == 1);
+    REQUIRE(std::string(c.output) == "f");
+    REQUIRE(c.color == nullptr);
+    REQUIRE(c.jobs == -12);
+    REQUIRE(c.includes.count == 2);
+
+    REQUIRE(optparse_long_bind(&o, kBindLongopts, binds, &arena) == OPTPARSE_ID_DONE);
+    REQUIRE(c.includes.count == 3);
+    REQUIRE(std::string(c.includes.items[0]) + c.includes.items[1] + c.includes.items[2] == "xyz");
+    REQUIRE(std::string(optparse_arg(&o)) == "a");
+}
+
+TEST_CASE("bind: bad integers and an exhausted arena are errors", "[bind]") {
+    bind_config     c;
+    optparse_bind_t binds[BIND_COUNT];
+    bind_setup(&c, binds);
+
+    /* room for the first 8-slot list, not for its doubling */
+    alignas(16) char mem[8 * sizeof(char*)];
+    optparse_arena_t arena;
+    optparse_arena_init(&arena, mem, sizeof(mem));
+
+    std::vector<std::string> args = {"prog", "-j", "4x", "-j+7", "-j-", "-j", "99999999999999999999999"};
+    for (int k = 0; k < 8; ++k) { args.push_back("-I" + std::to_string(k)); }
+    std::vector<char*> argv;
+    for (auto& a : args) { argv.push_back(&a[0]); }
+    argv.push_back(nullptr);
+
+    optparse_t o;
+    optparse_init(&o, argv.data());
+    REQUIRE(optparse_long_bind(&o, kBindLongopts, binds, &arena) == OPTPARSE_ID_ERROR);
+    REQUIRE(std::string(o.errmsg) == "invalid integer -- '4x'");
+    REQUIRE(c.jobs == 1);
+    REQUIRE(optparse_long_bind(&o, kBindLongopts, binds, &arena) == OPTPARSE_ID_ERROR);
+    REQUIRE(c.jobs == 7);
+    REQUIRE(std::string(o.errmsg) == "invalid integer -- '-'");
+    REQUIRE(optparse_long_bind(&o, kBindLongopts, binds, &arena) == OPTPARSE_ID_ERROR);
+    REQUIRE(std::string(o.errmsg) == "invalid integer -- '99999999999999999999999'");
+    REQUIRE(optparse_long_bind(&o, kBindLongopts, binds, &arena) == OPTPARSE_ID_ERROR);
+    REQUIRE(std::string(o.errmsg) == "too many arguments -- '7'");
+    REQUIRE(c.includes.count == 7);
+    REQUIRE(optparse_long_bind(&o, kBindLongopts, binds, &arena) == OPTPARSE_ID_DONE);
+}
+
+TEST_CASE("bind: integer limits", "[bind]") {
+    const std::string max = std::to_string((unsigned long)-1 >> 1);
+    const std::string min = "-" + std::to_string(((unsigned long)-1 >> 1) + 1);
+    const std::string cases[][2] = {
+        {max, max}, {min, min}, {"-0", "0"}, {"+12", "12"}, {"007", "7"},
+        {max.substr(0, max.size() - 1) + "8", "error"}, {min.substr(0, min.size() - 1) + "9", "error"},
+        {"", "error"}, {"+", "error"}, {" 1", "error"}, {"1 ", "error"}, {"0x10", "error"},
+    };
+    bind_config     c;
+    optparse_bind_t binds[BIND_COUNT];
+    bind_setup(&c, binds);
+    for (auto& t : cases) {
+        std::string jobs   = "--jobs=" + t[0];
+        char*       argv[] = {(char*)"prog", &jobs[0], nullptr};
+        optparse_t  o;
+        optparse_init(&o, argv);
+        c.jobs      = 5;
+        const int r = optparse_long_bind(&o, kBindLongopts, binds, nullptr);
+        REQUIRE((r == OPTPARSE_ID_ERROR ? "error" : std::to_string(c.jobs)) == t[1]);
+    }
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "optparse/batch.h"
+#include "parse_all.hpp"
+
+static const optparse_long_t kClassifyLongopts[] = {
+    {"amend", 'a', OPTPARSE_NONE},     {"brief", 'b', OPTPARSE_NONE}, {"color", 'c', OPTPARSE_OPTIONAL},
+    {"delay", 'd', OPTPARSE_REQUIRED}, {"erase", 'e', OPTPARSE_NONE}, {nullptr, 0, OPTPARSE_NONE},
+};
+
+/* order 3 is OPTPARSE_PERMUTE with optparse_record(); the last parse_all() call, after permutation, must not trust
+ * the stale classes */
+static std::vector<std::string> parse_classified(const std::vector<std::string>& args, int order, bool classified) {
+    std::vector<unsigned char> classes(args.size(), 0xff);
+    std::vector<int>           pos(args.size() + 1);
+    optparse_mode_t            mode;
+    return parse_all(
+        args, [](optparse_t* o, int* li) { return optparse_long(o, kClassifyLongopts, li); },
+        [&](optparse_t* o, std::vector<char*>& argv) {
+            optparse_init(o, argv.data());
+            o->permute = order == 3 ? (int)OPTPARSE_PERMUTE : order;
+            if (order == 3) { optparse_record(o, &mode, pos.data(), (int)pos.size()); }
+            if (classified) {
+                REQUIRE(optparse_batch_classify(argv.data(), (int)classes.size(), classes.data(), 4) == 0);
+                for (unsigned char c : classes) { REQUIRE(c <= OPTPARSE_CLASS_DASHDASH); }
+                optparse_classes(o, &mode, classes.data(), (int)classes.size());
+            }
+        });
+}
+
+TEST_CASE("classify: token classes", "[classify]") {
+    char* argv[] = {(char*)"prog", (char*)"-", (char*)"--", (char*)"-a", (char*)"--all", (char*)"x", (char*)"---",
+                    (char*)""};
+    unsigned char classes[8];
+    optparse_classify(argv, 0, 8, classes);
+    const unsigned char expected[8] = {OPTPARSE_CLASS_POSITIONAL, OPTPARSE_CLASS_POSITIONAL, OPTPARSE_CLASS_DASHDASH,
+                                       OPTPARSE_CLASS_SHORT,      OPTPARSE_CLASS_LONG,       OPTPARSE_CLASS_POSITIONAL,
+                                       OPTPARSE_CLASS_LONG,       OPTPARSE_CLASS_POSITIONAL};
+    REQUIRE(std::vector<unsigned char>(classes, classes + 8) == std::vector<unsigned char>(expected, expected + 8));
+}
+
+TEST_CASE("classify: classified parse matches the plain one", "[classify]") {
+    static const char* pool[] = {"-a", "-b", "-d", "--delay", "--delay=3", "--color", "-cx", "--", "-", "x",
+                                 "y",  "-z", "--bogus", "-abd"};
+    std::mt19937       rng(99);
+    for (int iter = 0; iter < 300; ++iter) {
+        std::vector<std::string> args = {"prog"};
+        const int                n    = iter < 280 ? (int)(rng() % 24) : 20000 + (int)(rng() % 5000);
+        for (int k = 0; k < n; ++k) { args.push_back(pool[rng() % (sizeof(pool) / sizeof(pool[0]))]); }
+        for (int order : {(int)OPTPARSE_REQUIRE_ORDER, (int)OPTPARSE_PERMUTE, (int)OPTPARSE_RETURN_IN_ORDER, 3}) {
+            REQUIRE(parse_classified(args, order, true) == parse_classified(args, order, false));
+        }
+    }
+}
+
+TEST_CASE("classify: option arguments across block boundaries", "[classify]") {
+    /* "-d" ends each block, so its argument "-a" opens the next one with class SHORT */
+    std::vector<std::string> args = {"prog"};
+    for (int i = 1; i < 4 * OPTPARSE_BATCH_TOKENS; ++i) {
+        const int k = i % OPTPARSE_BATCH_TOKENS;
+        args.push_back(k == OPTPARSE_BATCH_TOKENS - 1 ? "-d" : k == 0 ? "-a" : "file");
+    }
+    const auto plain = parse_classified(args, OPTPARSE_PERMUTE, false);
+    REQUIRE(parse_classified(args, OPTPARSE_PERMUTE, true) == plain);
+    REQUIRE(plain[0] == std::to_string('d') + ":3:3:-a:");
+}
+
+TEST_CASE("prescan: classes and lengths", "[classify][prescan]") {
+    std::mt19937             rng(7);
+    std::vector<std::string> args;
+    for (int i = 0; i < 2000; ++i) {
+        std::string a = i % 5 == 0 ? "-" : i % 5 == 1 ? "--" : "";
+        const int   n = (int)(rng() % 40);
+        for (int k = 0; k < n; ++k) { a += (char)('a' + rng() % 26); }
+        args.push_back(a);
+    }
+    /* each string at every offset of a word, so the word loop sees all head and tail shapes */
+    std::vector<std::string> storage;
+    std::vector<char*>       argv;
+    for (size_t i = 0; i < args.size(); ++i) { storage.push_back(std::string(i % 8, '.') + args[i]); }
+    for (size_t i = 0; i < args.size(); ++i) { argv.push_back(&storage[i][i % 8]); }
+    argv.push_back(nullptr);
+
+    const int                  n = (int)args.size();
+    std::vector<unsigned char> expected(n), classes(n, 0xff);
+    std::vector<size_t>        lengths(n, 12345);
+    optparse_classify(argv.data(), 0, n, expected.data());
+    optparse_prescan(argv.data(), 0, n, classes.data(), lengths.data());
+    REQUIRE(classes == expected);
+    for (int i = 0; i < n; ++i) { REQUIRE(lengths[i] == args[i].size()); }
+
+    /* a sub-range leaves the rest alone */
+    std::fill(classes.begin(), classes.end(), 0xff);
+    optparse_prescan(argv.data(), 10, 20, classes.data(), nullptr);
+    REQUIRE(classes[9] == 0xff);
+    REQUIRE(classes[10] == expected[10]);
+    REQUIRE(classes[19] == expected[19]);
+    REQUIRE(classes[20] == 0xff);
+}
@@ -0,0 +1,96 @@
+#include <bitset>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+static const optparse_long_t kIdLongopts[] = {
+    {"verbose", 'v', OPTPARSE_NONE},
+    {"output", 'o', OPTPARSE_REQUIRED},
+    {"color", 0, OPTPARSE_OPTIONAL},
+    {"dry-run", 0, OPTPARSE_NONE},
+    {nullptr, 'q', OPTPARSE_NONE},
+    {"?", '?', OPTPARSE_NONE},
+    {nullptr, 0, OPTPARSE_NONE},
+};
+
+TEST_CASE("id: short and long spellings return the descriptor index", "[id]") {
+    char* argv[] = {(char*)"prog", (char*)"-v", (char*)"--output=f", (char*)"--color", (char*)"a", (char*)"-qoz",
+                    (char*)"--dry-run", (char*)"--verbose", (char*)"-?", (char*)"--nope", (char*)"-x", nullptr};
+    optparse_t o;
+    optparse_init(&o, argv);
+
+    std::bitset<6> seen;
+    const char*    values[6] = {};
+    int            id;
+    while ((id = optparse_long_id(&o, kIdLongopts)) != OPTPARSE_ID_DONE) {
+        if (id == OPTPARSE_ID_ERROR) { break; }
+        seen.set((size_t)id);
+        values[id] = o.optarg;
+    }
+    REQUIRE(id == OPTPARSE_ID_ERROR);
+    REQUIRE(std::string(o.errmsg) == "invalid option -- 'nope'");
+    REQUIRE(seen.to_string() == "111111");
+    REQUIRE(std::string(values[1]) == "z");
+    REQUIRE(values[2] == nullptr);
+
+    REQUIRE(optparse_long_id(&o, kIdLongopts) == OPTPARSE_ID_ERROR);
+    REQUIRE(std::string(o.errmsg) == "invalid option -- 'x'");
+    REQUIRE(optparse_long_id(&o, kIdLongopts) == OPTPARSE_ID_DONE);
+    REQUIRE(std::string(optparse_arg(&o)) == "a");
+}
+
+TEST_CASE("id: positionals in return-in-order mode", "[id]") {
+    char*      argv[] = {(char*)"prog", (char*)"a", (char*)"--output", nullptr};
+    optparse_t o;
+    optparse_init(&o, argv);
+    o.permute = OPTPARSE_RETURN_IN_ORDER;
+    REQUIRE(optparse_long_id(&o, kIdLongopts) == OPTPARSE_ID_POSITIONAL);
+    REQUIRE(std::string(o.optarg) == "a");
+    REQUIRE(optparse_long_id(&o, kIdLongopts) == OPTPARSE_ID_ERROR);
+    REQUIRE(std::string(o.errmsg) == "option requires an argument -- 'output'");
+    REQUIRE(optparse_long_id(&o, kIdLongopts) == OPTPARSE_ID_DONE);
+}
+
+TEST_CASE("id: same options as optparse_long()", "[id]") {
+    static const char* pool[] = {
+        "-v", "-o", "x", "--output=y", "--color", "--color=z", "-q", "-vq", "--dry-run", "--dry-run=1",
+        "--", "-", "-?", "--?", "-z", "--zz", "-oq",
+    };
+    std::mt19937 rng(24);
+    for (int iter = 0; iter < 3000; ++iter) {
+        std::vector<std::string> args = {"prog"};
+        const int                n    = (int)(rng() % 10);
+        for (int k = 0; k < n; ++k) { args.push_back(pool[rng() % (sizeof(pool) / sizeof(pool[0]))]); }
+        std::vector<char*> argv;
+        for (auto& a : args) { argv.push_back(&a[0]); }
+        argv.push_back(nullptr);
+
+        std::vector<char*> argv2 = argv;
+        optparse_t         o, o2;
+        optparse_init(&o, argv.data());
+        optparse_init(&o2, argv2.data());
+        for (;;) {
+            int       li = -1;
+            const int r  = optparse_long(&o, kIdLongopts, &li);
+            const int id = optparse_long_id(&o2, kIdLongopts);
+            REQUIRE(o.optind == o2.optind);
+            REQUIRE(std::string(o.errmsg) == o2.errmsg);
+            if (r == -1) {
+                REQUIRE(id == OPTPARSE_ID_DONE);
+                break;
+            }
+            if (o.errmsg[0]) {
+                REQUIRE(id == OPTPARSE_ID_ERROR);
+            } else {
+                REQUIRE(id == li);
+                REQUIRE(o.optarg == o2.optarg);
+            }
+        }
+    }
+}
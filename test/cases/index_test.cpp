@@ -0,0 +1,90 @@
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "parse_all.hpp"
+
+static const optparse_long_t kIndexLongopts[] = {
+    {"verbose", 'v', OPTPARSE_NONE},    {"output", 'o', OPTPARSE_REQUIRED}, {"color", 'c', OPTPARSE_OPTIONAL},
+    {"out", 256, OPTPARSE_NONE},        {"output", 'x', OPTPARSE_NONE},     {nullptr, 'q', OPTPARSE_NONE},
+    {"v", 'v', OPTPARSE_REQUIRED},      {"a=b", 257, OPTPARSE_NONE},        {nullptr, 0, OPTPARSE_NONE},
+};
+
+static std::vector<std::string> parse_both(const std::vector<std::string>& args, const optparse_long_t* lo,
+                                           const optparse_index_t* index) {
+    return parse_all(args, [&](optparse_t* o, int* li) {
+        return index ? optparse_long_indexed(o, index, li) : optparse_long(o, lo, li);
+    });
+}
+
+TEST_CASE("index: sorted order and duplicate handling", "[index]") {
+    optparse_index_t index;
+    int              order[16];
+    REQUIRE(optparse_index_init(&index, kIndexLongopts, order, 16) == 7);
+
+    for (int k = 1; k < index.count; ++k) {
+        REQUIRE(std::string(kIndexLongopts[order[k - 1]].longname) <= kIndexLongopts[order[k]].longname);
+    }
+    REQUIRE(index.shortidx['v'] == 0); /* first duplicate shortname wins */
+    REQUIRE(index.shortidx['q'] == 5); /* long-less entries still reachable by short name */
+    REQUIRE(index.shortidx['z'] == -1);
+}
+
+TEST_CASE("index: capacity too small", "[index][error]") {
+    optparse_index_t index;
+    int              order[3];
+    REQUIRE(optparse_index_init(&index, kIndexLongopts, order, 3) == -1);
+}
+
+TEST_CASE("index: empty table", "[index]") {
+    static const optparse_long_t lo[] = {{nullptr, 0, OPTPARSE_NONE}};
+    optparse_index_t             index;
+    REQUIRE(optparse_index_init(&index, lo, nullptr, 0) == 0);
+    const std::vector<std::string> args = {"prog", "--foo", "-a", "bar"};
+    REQUIRE(parse_both(args, lo, &index) == parse_both(args, lo, nullptr));
+}
+
+TEST_CASE("index: same results as optparse_long()", "[index]") {
+    optparse_index_t index;
+    int              order[16];
+    optparse_index_init(&index, kIndexLongopts, order, 16);
+
+    const std::vector<std::vector<std::string>> cases = {
+        {"prog", "--verbose", "--output", "f", "--out", "--color", "--color=red"},
+        {"prog", "pos", "--output=x", "-vq", "-ofile", "--", "--verbose"},
+        {"prog", "--outpu", "--outputs", "--v", "--v=1", "--verbose=1", "-z", "--a=b"},
+        {"prog", "--output"},
+        {"prog", "-o"},
+        {"prog", "-", "--=", "--out=1"},
+    };
+    for (const auto& args : cases) {
+        REQUIRE(parse_both(args, kIndexLongopts, &index) == parse_both(args, kIndexLongopts, nullptr));
+    }
+}
+
+TEST_CASE("index: large table lookup", "[index]") {
+    const int                    n = 1800;
+    std::vector<std::string>     names;
+    std::vector<optparse_long_t> lo;
+    for (int i = 0; i < n; ++i) { names.push_back("opt-" + std::to_string((i * 7919) % n)); }
+    for (int i = 0; i < n; ++i) {
+        lo.push_back({names[i].c_str(), 1000 + i, i % 3 == 0 ? OPTPARSE_REQUIRED : OPTPARSE_NONE, nullptr, nullptr});
+    }
+    lo.push_back({nullptr, 0, OPTPARSE_NONE, nullptr, nullptr});
+
+    std::vector<int> order(n);
+    optparse_index_t index;
+    REQUIRE(optparse_index_init(&index, lo.data(), order.data(), n) == n);
+
+    std::vector<std::string> args = {"prog"};
+    for (int i = 0; i < n; i += 13) {
+        args.push_back("--" + names[i]);
+        if (i % 3 == 0) { args.push_back("v" + std::to_string(i)); }
+    }
+    args.push_back("--opt-unknown");
+    REQUIRE(parse_both(args, lo.data(), &index) == parse_both(args, lo.data(), nullptr));
+}
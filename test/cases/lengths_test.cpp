@@ -0,0 +1,125 @@
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "parse_all.hpp"
+
+static const optparse_long_t kLengthsLongopts[] = {
+    {"amend", 'a', OPTPARSE_NONE},     {"brief", 'b', OPTPARSE_NONE}, {"color", 'c', OPTPARSE_OPTIONAL},
+    {"delay", 'd', OPTPARSE_REQUIRED}, {"erase", 'e', OPTPARSE_NONE}, {nullptr, 0, OPTPARSE_NONE},
+};
+
+/* a full parse; counted, optarglen must match strlen(optarg) */
+static std::vector<std::string> parse_counted(const std::vector<std::string>& args, int order, bool counted) {
+    std::vector<size_t> lengths;
+    optparse_mode_t     mode;
+    return parse_all(
+        args,
+        [&](optparse_t* o, int* li) {
+            const int r = optparse_long(o, kLengthsLongopts, li);
+            if (r != -1 && o->optarg) {
+                REQUIRE(o->optarglen == (counted ? (ptrdiff_t)strlen(o->optarg) : -1));
+            } else if (r != -1) {
+                REQUIRE(o->optarglen == -1);
+            }
+            return r;
+        },
+        [&](optparse_t* o, std::vector<char*>& argv) {
+            if (counted) {
+                for (size_t i = 0; i + 1 < argv.size(); ++i) { lengths.push_back(strlen(argv[i])); }
+                argv.back() = const_cast<char*>("-a"); /* not a terminator: a counted parse must stop before it */
+                optparse_init_lengths(o, &mode, argv.data(), (int)lengths.size(), lengths.data());
+            } else {
+                optparse_init(o, argv.data());
+            }
+            o->permute = order;
+        });
+}
+
+TEST_CASE("lengths: optarglen for every argument form", "[lengths]") {
+    char   big[]  = "--delay=0123456789";
+    char*  argv[] = {(char*)"prog",    (char*)"-d7", (char*)"-d",      (char*)"42",      big,
+                     (char*)"--delay", (char*)"x",   (char*)"-cvalue", (char*)"--color", (char*)"tail"};
+    size_t lengths[10];
+    for (int i = 0; i < 10; ++i) { lengths[i] = strlen(argv[i]); }
+
+    optparse_t      o;
+    optparse_mode_t mode;
+    optparse_init_lengths(&o, &mode, argv, 10, lengths);
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == 'd');
+    REQUIRE(o.optarglen == 1);
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == 'd');
+    REQUIRE(o.optarglen == 2);
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == 'd');
+    REQUIRE(o.optarglen == 10);
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == 'd');
+    REQUIRE(o.optarglen == 1);
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == 'c');
+    REQUIRE(o.optarglen == 5);
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == 'c');
+    REQUIRE(o.optarg == nullptr);
+    REQUIRE(o.optarglen == -1);
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == -1);
+    REQUIRE(std::string(optparse_arg(&o)) == "tail");
+    REQUIRE(optparse_arg(&o) == nullptr);
+
+    /* the reported length wins: the parser never looks for the value's end */
+    lengths[4] = 8 + 4;
+    optparse_init_lengths(&o, &mode, argv, 5, lengths);
+    o.optind = 4;
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == 'd');
+    REQUIRE(o.optarglen == 4);
+}
+
+TEST_CASE("lengths: counted sub-range of a larger array", "[lengths]") {
+    char* all[] = {(char*)"x", (char*)"prog", (char*)"-a", (char*)"-d", (char*)"--brief", (char*)"-e"};
+
+    optparse_t      o;
+    optparse_mode_t mode;
+    optparse_init_lengths(&o, &mode, all + 1, 3, nullptr); /* "prog -a -d": -d is missing its argument */
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == 'a');
+    REQUIRE(o.optarglen == -1);
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == '?');
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == -1);
+
+    optparse_init_lengths(&o, &mode, all + 1, 4, nullptr);
+    o.optind = 2;
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == 'd');
+    REQUIRE(std::string(o.optarg) == "--brief");
+
+    optparse_init_lengths(&o, &mode, all, 0, nullptr);
+    REQUIRE(o.optind == 0);
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == -1);
+    REQUIRE(optparse_arg(&o) == nullptr);
+}
+
+TEST_CASE("lengths: unknown long option with a large value", "[lengths][error]") {
+    std::string big       = "--bogus=" + std::string(1 << 20, 'v');
+    char*       argv[]    = {(char*)"prog", &big[0]};
+    size_t      lengths[] = {4, big.size()};
+    optparse_t      o;
+    optparse_mode_t mode;
+    optparse_init_lengths(&o, &mode, argv, 2, lengths);
+    REQUIRE(optparse_long(&o, kLengthsLongopts, nullptr) == '?');
+    REQUIRE(std::string(o.errmsg).find("bogus=vvv") != std::string::npos);
+}
+
+TEST_CASE("lengths: counted parse matches the terminated one", "[lengths]") {
+    static const char* pool[] = {"-a", "-b", "-d", "--delay", "--delay=3", "--color", "-cx", "--color=",
+                                 "--", "-",  "x",  "-z",      "--bogus",   "-abd",    "-ad9"};
+    std::mt19937       rng(5);
+    for (int iter = 0; iter < 2000; ++iter) {
+        std::vector<std::string> args = {"prog"};
+        const int                n    = (int)(rng() % 12);
+        for (int k = 0; k < n; ++k) { args.push_back(pool[rng() % (sizeof(pool) / sizeof(pool[0]))]); }
+        for (int order : {(int)OPTPARSE_REQUIRE_ORDER, (int)OPTPARSE_PERMUTE, (int)OPTPARSE_RETURN_IN_ORDER}) {
+            REQUIRE(parse_counted(args, order, true) == parse_counted(args, order, false));
+        }
+    }
+}
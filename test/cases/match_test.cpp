@@ -0,0 +1,124 @@
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+/* byte-at-a-time reference for "--option" against a table: index of the match, or -1 */
+static int match_reference(const std::vector<std::string>& names, const std::string& option) {
+    const std::string name = option.substr(0, option.find('='));
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) { return (int)i; }
+    }
+    return -1;
+}
+
+static int match_both(const optparse_long_t* lo, const optparse_index_t* index, char* arg, std::string* value) {
+    char*      argv[] = {(char*)"prog", arg, nullptr};
+    optparse_t o;
+    int        li = -1;
+    optparse_init(&o, argv);
+    const int r = optparse_long(&o, lo, &li);
+    *value      = o.optarg ? o.optarg : "<null>";
+
+    optparse_t o2;
+    int        li2 = -1;
+    optparse_init(&o2, argv);
+    REQUIRE(optparse_long_indexed(&o2, index, &li2) == r);
+    REQUIRE(li2 == (r == '?' ? -1 : li));
+    return r == '?' ? -1 : li;
+}
+
+TEST_CASE("match: long names of every length against near misses", "[match]") {
+    std::vector<std::string> names;
+    const std::string        base = "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghij";
+    for (size_t len = 1; len <= 70; len += 3) { names.push_back(base.substr(0, len) + "_" + std::to_string(len)); }
+
+    std::vector<optparse_long_t> lo;
+    for (auto& n : names) { lo.push_back({n.c_str(), 0, OPTPARSE_OPTIONAL}); }
+    lo.push_back({nullptr, 0, OPTPARSE_NONE});
+    std::vector<int> order(names.size());
+    optparse_index_t index;
+    REQUIRE(optparse_index_init(&index, lo.data(), order.data(), (int)order.size()) == (int)names.size());
+
+    std::mt19937 rng(3);
+    for (int iter = 0; iter < 20000; ++iter) {
+        std::string option = names[rng() % names.size()];
+        switch (rng() % 5) {
+            case 0: option[rng() % option.size()] ^= 1 + (char)(rng() % 3); break; /* flip a byte */
+            case 1: option.resize(rng() % option.size()); break;                   /* prefix */
+            case 2: option += (char)('a' + rng() % 26); break;                      /* extension */
+            default: break;
+        }
+        if (rng() % 2) { option += "=" + std::string(rng() % 40, 'v'); }
+        if (option.empty() || option[0] == '=') { continue; }
+
+        std::string arg   = "--" + option;
+        std::string value;
+        const int   got   = match_both(lo.data(), &index, &arg[0], &value);
+        REQUIRE(got == match_reference(names, option));
+        if (got >= 0) {
+            const size_t eq = option.find('=');
+            REQUIRE(value == (eq == std::string::npos ? "<null>" : option.substr(eq + 1)));
+        }
+    }
+}
+
+TEST_CASE("match: value text after '=' is never read", "[match]") {
+    static const optparse_long_t lo[] = {
+        {"payload", 'p', OPTPARSE_REQUIRED},
+        {nullptr, 0, OPTPARSE_NONE},
+    };
+    std::string arg = "--payload=" + std::string(1 << 16, 'x');
+    arg[20]         = '='; /* a later '=' belongs to the value */
+    char*      argv[] = {(char*)"prog", &arg[0], nullptr};
+    optparse_t o;
+    optparse_init(&o, argv);
+    REQUIRE(optparse_long(&o, lo, nullptr) == 'p');
+    REQUIRE(o.optarg == &arg[10]);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("match: names ending at a page boundary", "[match]") {
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char* mem = (char*)mmap(nullptr, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    REQUIRE(mem != MAP_FAILED);
+    REQUIRE(mprotect(mem + page, page, PROT_NONE) == 0);
+
+    /* both the argument and the long name end on the last byte before the guard page */
+    for (size_t len = 1; len < 40; ++len) {
+        std::string name(len, 'n');
+        std::string option = "--" + name;
+        char*       name_at = mem + page - (len + 1);
+        memcpy(name_at, name.c_str(), len + 1);
+        char arg[64];
+        memcpy(arg, option.c_str(), option.size() + 1);
+
+        const optparse_long_t lo[] = {{name_at, 'n', OPTPARSE_NONE}, {nullptr, 0, OPTPARSE_NONE}};
+        char*                 argv[] = {(char*)"prog", arg, nullptr};
+        optparse_t            o;
+        optparse_init(&o, argv);
+        REQUIRE(optparse_long(&o, lo, nullptr) == 'n');
+
+        /* and the other way round */
+        char* arg_at = mem + page - (option.size() + 1);
+        memcpy(arg_at, option.c_str(), option.size() + 1);
+        argv[1] = arg_at;
+        optparse_init(&o, argv);
+        const optparse_long_t lo2[] = {{"nnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnnn", 'n', OPTPARSE_NONE},
+                                       {nullptr, 0, OPTPARSE_NONE}};
+        REQUIRE(optparse_long(&o, lo2, nullptr) == '?');
+    }
+    munmap(mem, 2 * page);
+}
+#endif
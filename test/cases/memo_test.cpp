@@ -0,0 +1,166 @@
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "optparse/memo.h"
+
+static const optparse_long_t kMemoLongopts[] = {
+    {"amend", 'a', OPTPARSE_NONE},     {"brief", 'b', OPTPARSE_NONE}, {"color", 'c', OPTPARSE_OPTIONAL},
+    {"delay", 'd', OPTPARSE_REQUIRED}, {"erase", 'e', OPTPARSE_NONE}, {nullptr, 0, OPTPARSE_NONE},
+};
+
+/* owns a fresh copy of the arguments, so each parse sees different pointers */
+struct MemoArgs {
+    std::vector<std::string> strings;
+    std::vector<char*>       argv;
+
+    explicit MemoArgs(const std::vector<std::string>& args) : strings(args) {
+        for (auto& s : strings) { argv.push_back(&s[0]); }
+        argv.push_back(nullptr);
+    }
+};
+
+/* events and positionals flattened to text, with optarg checked to point into argv */
+static std::vector<std::string> describe(const optparse_memo_result_t& r, char** argv) {
+    std::vector<std::string> out;
+    for (int k = 0; k < r.count; ++k) {
+        const optparse_event_t& ev = r.events[k];
+        std::string             s  = std::to_string(ev.option) + "/" + std::to_string(ev.longindex) + "/" +
+                        std::to_string(ev.argind) + "/";
+        if (ev.optarg) {
+            REQUIRE(((ev.optarg >= argv[ev.argind] && ev.optarg <= argv[ev.argind] + strlen(argv[ev.argind])) ||
+                     ev.optarg == argv[ev.argind + 1]));
+            s += ev.optarg;
+        } else {
+            s += "<null>";
+        }
+        out.push_back(s);
+    }
+    for (int k = 0; k < r.npos; ++k) { out.push_back(std::string("pos:") + argv[r.positionals[k]]); }
+    out.push_back(std::string("err:") + r.errmsg);
+    return out;
+}
+
+/* the same parse without a memo: optparse_long_all() in record mode */
+static std::vector<std::string> reference(const std::vector<std::string>& args) {
+    MemoArgs                      a(args);
+    optparse_t                    o;
+    optparse_mode_t               mode;
+    std::vector<int>              pos(args.size() + 1);
+    std::vector<optparse_event_t> events(args.size() * 2 + 1);
+
+    optparse_init(&o, a.argv.data());
+    optparse_record(&o, &mode, pos.data(), (int)pos.size());
+    optparse_memo_result_t r;
+    r.events      = events.data();
+    r.count       = optparse_long_all(&o, kMemoLongopts, events.data(), (int)events.size());
+    r.errmsg      = r.count && events[r.count - 1].option == '?' ? o.errmsg : "";
+    std::vector<int> all(pos.begin(), pos.begin() + mode.posc);
+    if (!*r.errmsg) {
+        for (char* p; (p = a.argv[o.optind]) != nullptr; ++o.optind) { all.push_back(o.optind); }
+    }
+    r.positionals = all.data();
+    r.npos        = (int)all.size();
+    return describe(r, a.argv.data());
+}
+
+TEST_CASE("memo: replays the same results as a fresh parse", "[memo]") {
+    const std::vector<std::vector<std::string>> cases = {
+        {"prog", "x", "-ab", "--delay", "10", "y", "-cblue", "--color", "-d", "5", "z"},
+        {"prog", "-d", "", "--delay=", "--color=", "-abd7", "--", "-a", "tail"},
+        {"prog", "-a", "--bogus", "-b"},
+        {"prog", "-a", "-d"},
+        {"prog"},
+    };
+    optparse_memo_t* memo = optparse_memo_new(8);
+    REQUIRE(memo != nullptr);
+    for (int round = 0; round < 3; ++round) {
+        for (const auto& args : cases) {
+            MemoArgs               a(args);
+            optparse_memo_result_t r;
+            REQUIRE(optparse_memo_parse(memo, a.argv.data(), kMemoLongopts, &r) == 0);
+            REQUIRE(r.hit == (round > 0));
+            REQUIRE(describe(r, a.argv.data()) == reference(args));
+        }
+    }
+    optparse_memo_free(memo);
+}
+
+TEST_CASE("memo: key covers argument bytes and table identity", "[memo]") {
+    static const optparse_long_t other[] = {
+        {"amend", 'a', OPTPARSE_REQUIRED},
+        {nullptr, 0, OPTPARSE_NONE},
+    };
+    optparse_memo_t*       memo = optparse_memo_new(8);
+    optparse_memo_result_t r;
+
+    MemoArgs first({"prog", "-a", "x"});
+    REQUIRE(optparse_memo_parse(memo, first.argv.data(), kMemoLongopts, &r) == 0);
+    REQUIRE(r.hit == 0);
+
+    /* argv[0] is not part of the key */
+    MemoArgs renamed({"other", "-a", "x"});
+    REQUIRE(optparse_memo_parse(memo, renamed.argv.data(), kMemoLongopts, &r) == 0);
+    REQUIRE(r.hit == 1);
+
+    /* same total bytes, different split between elements */
+    MemoArgs split({"prog", "-ax", ""});
+    REQUIRE(optparse_memo_parse(memo, split.argv.data(), kMemoLongopts, &r) == 0);
+    REQUIRE(r.hit == 0);
+
+    MemoArgs again({"prog", "-a", "x"});
+    REQUIRE(optparse_memo_parse(memo, again.argv.data(), other, &r) == 0);
+    REQUIRE(r.hit == 0);
+    REQUIRE(r.count == 1);
+    REQUIRE(std::string(r.events[0].optarg) == "x");
+    REQUIRE(r.events[0].optarg == again.argv[2]);
+    optparse_memo_free(memo);
+}
+
+TEST_CASE("memo: least recently used entry is evicted", "[memo]") {
+    optparse_memo_t*       memo = optparse_memo_new(2);
+    optparse_memo_result_t r;
+    auto                   parse = [&](const char* arg) {
+        MemoArgs a({"prog", arg});
+        REQUIRE(optparse_memo_parse(memo, a.argv.data(), kMemoLongopts, &r) == 0);
+        return r.hit;
+    };
+
+    REQUIRE(parse("-a") == 0);
+    REQUIRE(parse("-b") == 0);
+    REQUIRE(parse("-a") == 1); /* -b is now the oldest */
+    REQUIRE(parse("-e") == 0);
+    REQUIRE(parse("-a") == 1);
+    REQUIRE(parse("-b") == 0);
+    REQUIRE(parse("-e") == 0);
+    optparse_memo_free(memo);
+
+    /* a zero bound still parses, it just never hits */
+    memo = optparse_memo_new(0);
+    REQUIRE(parse("--bogus") == 0);
+    REQUIRE(r.count == 1);
+    REQUIRE(std::string(r.errmsg).find("bogus") != std::string::npos);
+    REQUIRE(parse("--bogus") == 0);
+    optparse_memo_free(memo);
+}
+
+TEST_CASE("memo: many events grow the scratch arrays", "[memo]") {
+    std::vector<std::string> args = {"prog"};
+    for (int i = 0; i < 1000; ++i) { args.push_back(i % 2 ? "file" + std::to_string(i) : "-d" + std::to_string(i)); }
+    optparse_memo_t* memo = optparse_memo_new(4);
+    for (int round = 0; round < 2; ++round) {
+        MemoArgs               a(args);
+        optparse_memo_result_t r;
+        REQUIRE(optparse_memo_parse(memo, a.argv.data(), kMemoLongopts, &r) == 0);
+        REQUIRE(r.hit == round);
+        REQUIRE(r.count == 500);
+        REQUIRE(r.npos == 500);
+        REQUIRE(std::string(r.events[499].optarg) == "998");
+        REQUIRE(std::string(a.argv[r.positionals[499]]) == "file999");
+    }
+    optparse_memo_free(memo);
+}
@@ -0,0 +1,90 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "parse_all.hpp"
+
+static const optparse_long_t kPackedLongopts[] = {
+    {"verbose", 'v', OPTPARSE_NONE},
+    {"output", 'o', OPTPARSE_REQUIRED},
+    {"color", 'c', OPTPARSE_OPTIONAL},
+    {"out", 256, OPTPARSE_NONE},
+    {"output", 'x', OPTPARSE_NONE},
+    {nullptr, 'q', OPTPARSE_NONE},
+    {"sixteen-bytes-ab", 257, OPTPARSE_NONE},
+    {"sixteen-bytes-abc", 258, OPTPARSE_REQUIRED},
+    {"sixteen-bytes-abd", 259, OPTPARSE_OPTIONAL},
+    {"", 260, OPTPARSE_NONE},
+    {"a=b", 261, OPTPARSE_NONE},
+    {nullptr, 0, OPTPARSE_NONE},
+};
+
+static std::vector<std::string> parse_both(const std::vector<std::string>& args, const optparse_long_t* lo,
+                                           const optparse_packed_t* packed) {
+    return parse_all(args, [&](optparse_t* o, int* li) {
+        return packed ? optparse_long_packed(o, packed, li) : optparse_long(o, lo, li);
+    });
+}
+
+TEST_CASE("packed: rows and capacity", "[packed]") {
+    optparse_packed_t     packed;
+    optparse_packed_row_t rows[16];
+    REQUIRE(optparse_packed_init(&packed, kPackedLongopts, rows, 10) == -1);
+    REQUIRE(optparse_packed_init(&packed, kPackedLongopts, rows, 16) == 11);
+    REQUIRE(std::string((const char*)rows[0].head) == "verbose");
+    REQUIRE(std::string((const char*)rows[7].head, 16) == "sixteen-bytes-ab");
+    REQUIRE(packed.shortidx['o'] == 1);
+    REQUIRE(packed.shortidx['q'] == 5);
+    REQUIRE(packed.shortidx['z'] == -1);
+}
+
+TEST_CASE("packed: same results as optparse_long()", "[packed]") {
+    optparse_packed_t     packed;
+    optparse_packed_row_t rows[16];
+    optparse_packed_init(&packed, kPackedLongopts, rows, 16);
+
+    static const char* pool[] = {
+        "--output", "--output=f", "--out", "--outp", "--color", "--color=x", "--verbose", "--verbose=1",
+        "--sixteen-bytes-ab", "--sixteen-bytes-abc", "--sixteen-bytes-abd=v", "--sixteen-bytes-a",
+        "--sixteen-bytes-abcd", "--sixteen-bytes-ab=", "--=", "--a=b", "--a", "-q", "-o", "x", "--", "-", "-vx",
+    };
+    std::mt19937 rng(11);
+    for (int iter = 0; iter < 3000; ++iter) {
+        std::vector<std::string> args = {"prog"};
+        const int                n    = (int)(rng() % 10);
+        for (int k = 0; k < n; ++k) { args.push_back(pool[rng() % (sizeof(pool) / sizeof(pool[0]))]); }
+        REQUIRE(parse_both(args, kPackedLongopts, &packed) == parse_both(args, kPackedLongopts, nullptr));
+    }
+}
+
+TEST_CASE("packed: near misses around the 16-byte prefix", "[packed]") {
+    /* 40 names sharing long prefixes, so many rows tie on their first 16 bytes */
+    std::vector<std::string> names;
+    for (int len = 1; len <= 40; ++len) { names.push_back(std::string(len, 'p') + std::to_string(len % 7)); }
+    std::vector<optparse_long_t> lo;
+    for (auto& n : names) { lo.push_back({n.c_str(), 0, OPTPARSE_OPTIONAL}); }
+    lo.push_back({nullptr, 0, OPTPARSE_NONE});
+
+    std::vector<optparse_packed_row_t> rows(lo.size());
+    optparse_packed_t                  packed;
+    REQUIRE(optparse_packed_init(&packed, lo.data(), rows.data(), (int)rows.size()) == (int)names.size());
+
+    std::mt19937 rng(5);
+    for (int iter = 0; iter < 5000; ++iter) {
+        std::string option = names[rng() % names.size()];
+        switch (rng() % 4) {
+            case 0: option[rng() % option.size()] ^= 1; break;
+            case 1: option.resize(rng() % option.size() + 1); break;
+            case 2: option += 'p'; break;
+            default: break;
+        }
+        if (rng() % 2) { option += "=v"; }
+        std::vector<std::string> args = {"prog", "--" + option};
+        REQUIRE(parse_both(args, lo.data(), &packed) == parse_both(args, lo.data(), nullptr));
+    }
+}
@@ -0,0 +1,70 @@
+#ifdef __linux__
+
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "optparse/proc.h"
+
+struct ProcSeen {
+    bool                     self = false;
+    std::vector<std::string> args;
+    long                     calls = 0;
+};
+
+static int proc_visit(optparse_proc_t* scan, optparse_t* options, void* userdata) {
+    ProcSeen* seen = static_cast<ProcSeen*>(userdata);
+    ++seen->calls;
+    REQUIRE(options->argv[0] != nullptr);
+    REQUIRE(scan->buf[scan->len - 1] == '\0');
+    if (scan->pid == getpid()) {
+        static const optparse_long_t lo[] = {{nullptr, 0, OPTPARSE_NONE}};
+        seen->self                        = true;
+        seen->args.push_back(options->argv[0]);
+        for (int r; (r = optparse_long(options, lo, nullptr)) != -1;) {
+            if (r == 1) { seen->args.push_back(options->optarg); }
+        }
+    }
+    return 0;
+}
+
+static int proc_stop(optparse_proc_t*, optparse_t*, void* userdata) {
+    ++*static_cast<long*>(userdata);
+    return 1;
+}
+
+TEST_CASE("proc: scan finds this process", "[proc]") {
+    optparse_proc_t scan;
+    ProcSeen        seen;
+    optparse_proc_init(&scan);
+
+    const long n = optparse_proc_scan(&scan, proc_visit, &seen);
+    REQUIRE(n > 0);
+    REQUIRE(n == seen.calls);
+    REQUIRE(seen.self);
+    REQUIRE(seen.args.size() >= 1);
+
+    /* the buffer is reused: a second scan does not shrink or reallocate it below its size */
+    const size_t cap = scan.cap;
+    REQUIRE(optparse_proc_scan(&scan, proc_visit, &seen) > 0);
+    REQUIRE(scan.cap >= cap);
+    REQUIRE(scan.visited == (unsigned long)seen.calls);
+    optparse_proc_free(&scan);
+}
+
+TEST_CASE("proc: callback stops the scan", "[proc]") {
+    optparse_proc_t scan;
+    long            calls = 0;
+    optparse_proc_init(&scan);
+    REQUIRE(optparse_proc_scan(&scan, proc_stop, &calls) == 1);
+    REQUIRE(calls == 1);
+    optparse_proc_free(&scan);
+}
+
+#endif
@@ -0,0 +1,179 @@
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "optparse/response.h"
+
+static std::string write_file(const std::string& name, const std::string& content) {
+    FILE* f = std::fopen(name.c_str(), "wb");
+    REQUIRE(f != nullptr);
+    std::fwrite(content.data(), 1, content.size(), f);
+    std::fclose(f);
+    return name;
+}
+
+static std::vector<std::string> expand(std::initializer_list<const char*> args) {
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>("prog"));
+    for (auto a : args) { argv.push_back(const_cast<char*>(a)); }
+    argv.push_back(nullptr);
+
+    optparse_rsp_t rsp;
+    REQUIRE(optparse_rsp_expand(&rsp, argv.data()) == 0);
+    REQUIRE(rsp.argv[rsp.argc] == nullptr);
+    std::vector<std::string> out(rsp.argv, rsp.argv + rsp.argc);
+    optparse_rsp_free(&rsp);
+    return out;
+}
+
+TEST_CASE("rsp: tokens, quotes and escapes", "[rsp]") {
+    write_file("optparse_rsp_a.rsp", "  -a --delay 10\n'single quoted' \"double \\\"q\\\"\"\tesc\\ aped ''\r\nlast");
+    auto out      = expand({"x", "@optparse_rsp_a.rsp", "y"});
+    auto expected = std::vector<std::string>{
+        "prog", "x", "-a", "--delay", "10", "single quoted", "double \"q\"", "esc aped", "", "last", "y"};
+    REQUIRE(out == expected);
+    std::remove("optparse_rsp_a.rsp");
+}
+
+TEST_CASE("rsp: last token shrunk by quotes at end of file", "[rsp]") {
+    write_file("optparse_rsp_b.rsp", "a \"b c\"");
+    REQUIRE(expand({"@optparse_rsp_b.rsp"}) == (std::vector<std::string>{"prog", "a", "b c"}));
+    std::remove("optparse_rsp_b.rsp");
+}
+
+TEST_CASE("rsp: nested, empty and missing files", "[rsp]") {
+    write_file("optparse_rsp_inner.rsp", "inner1 inner2\n");
+    write_file("optparse_rsp_outer.rsp", "o1 @optparse_rsp_inner.rsp o2");
+    write_file("optparse_rsp_empty.rsp", "");
+    write_file("optparse_rsp_loop.rsp", "@optparse_rsp_loop.rsp");
+
+    auto out = expand({"@optparse_rsp_outer.rsp", "@optparse_rsp_empty.rsp", "@optparse_rsp_missing.rsp", "@"});
+    auto expected =
+        std::vector<std::string>{"prog", "o1", "inner1", "inner2", "o2", "@optparse_rsp_missing.rsp", "@"};
+    REQUIRE(out == expected);
+
+    /* self-reference stops at the depth limit and keeps the element literally */
+    REQUIRE(expand({"@optparse_rsp_loop.rsp"}) == (std::vector<std::string>{"prog", "@optparse_rsp_loop.rsp"}));
+
+    std::remove("optparse_rsp_inner.rsp");
+    std::remove("optparse_rsp_outer.rsp");
+    std::remove("optparse_rsp_empty.rsp");
+    std::remove("optparse_rsp_loop.rsp");
+}
+
+TEST_CASE("rsp: expanded argv parses like a real one", "[rsp]") {
+    static const optparse_long_t lo[] = {
+        {"amend", 'a', OPTPARSE_NONE},
+        {"delay", 'd', OPTPARSE_REQUIRED},
+        {nullptr, 0, OPTPARSE_NONE},
+    };
+    write_file("optparse_rsp_c.rsp", "file1 --delay\n'5 0'\n-a file2");
+
+    char*          argv[] = {const_cast<char*>("prog"), const_cast<char*>("@optparse_rsp_c.rsp"), nullptr};
+    optparse_rsp_t rsp;
+    REQUIRE(optparse_rsp_expand(&rsp, argv) == 0);
+
+    optparse_t o;
+    optparse_init(&o, rsp.argv);
+    REQUIRE(optparse_long(&o, lo, nullptr) == 'd');
+    REQUIRE(std::string(o.optarg) == "5 0");
+    REQUIRE(optparse_long(&o, lo, nullptr) == 'a');
+    REQUIRE(optparse_long(&o, lo, nullptr) == -1);
+    REQUIRE(std::string(optparse_arg(&o)) == "file1");
+    REQUIRE(std::string(optparse_arg(&o)) == "file2");
+    REQUIRE(optparse_arg(&o) == nullptr);
+
+    optparse_rsp_free(&rsp);
+    std::remove("optparse_rsp_c.rsp");
+}
+
+TEST_CASE("rsp cache: hits share tokens, changes reload", "[rsp][cache]") {
+    write_file("optparse_rsp_d.rsp", "-a --delay 10");
+    optparse_rsp_cache_t* cache  = optparse_rsp_cache_new(1 << 20);
+    char*                 argv[] = {const_cast<char*>("prog"), const_cast<char*>("@optparse_rsp_d.rsp"), nullptr};
+    optparse_rsp_t        r1, r2, r3;
+    REQUIRE(cache != nullptr);
+
+    REQUIRE(optparse_rsp_expand_cached(&r1, argv, cache) == 0);
+    REQUIRE(optparse_rsp_expand_cached(&r2, argv, cache) == 0);
+    REQUIRE(r1.argc == 4);
+    REQUIRE(r1.argv != r2.argv);
+    for (int i = 1; i < r1.argc; ++i) { REQUIRE(r1.argv[i] == r2.argv[i]); }
+    optparse_rsp_free(&r2);
+
+    /* a different size (and mtime) invalidates the entry; r1 keeps the old tokens alive */
+    write_file("optparse_rsp_d.rsp", "-b --delay 200");
+    REQUIRE(optparse_rsp_expand_cached(&r3, argv, cache) == 0);
+    REQUIRE(std::vector<std::string>(r3.argv, r3.argv + r3.argc) ==
+            (std::vector<std::string>{"prog", "-b", "--delay", "200"}));
+    REQUIRE(std::vector<std::string>(r1.argv, r1.argv + r1.argc) ==
+            (std::vector<std::string>{"prog", "-a", "--delay", "10"}));
+
+    optparse_rsp_free(&r1);
+    optparse_rsp_free(&r3);
+    optparse_rsp_cache_free(cache);
+    std::remove("optparse_rsp_d.rsp");
+}
+
+TEST_CASE("rsp cache: byte bound evicts least recently used files", "[rsp][cache]") {
+    write_file("optparse_rsp_e.rsp", "e1 e2");
+    write_file("optparse_rsp_f.rsp", "f1 @optparse_rsp_e.rsp");
+    optparse_rsp_cache_t* cache  = optparse_rsp_cache_new(0);
+    char*                 argv[] = {const_cast<char*>("prog"), const_cast<char*>("@optparse_rsp_f.rsp"), nullptr};
+
+    /* nothing fits, so every expansion reloads, but results stay correct */
+    for (int k = 0; k < 3; ++k) {
+        optparse_rsp_t rsp;
+        REQUIRE(optparse_rsp_expand_cached(&rsp, argv, cache) == 0);
+        REQUIRE(std::vector<std::string>(rsp.argv, rsp.argv + rsp.argc) ==
+                (std::vector<std::string>{"prog", "f1", "e1", "e2"}));
+        optparse_rsp_free(&rsp);
+    }
+    optparse_rsp_cache_free(cache);
+    std::remove("optparse_rsp_e.rsp");
+    std::remove("optparse_rsp_f.rsp");
+}
+
+TEST_CASE("rsp cache: concurrent expansion and parsing", "[rsp][cache]") {
+    static const optparse_long_t lo[] = {
+        {"amend", 'a', OPTPARSE_NONE},
+        {"delay", 'd', OPTPARSE_REQUIRED},
+        {nullptr, 0, OPTPARSE_NONE},
+    };
+    write_file("optparse_rsp_g.rsp", "in1 -a --delay 7 in2 -a");
+    optparse_rsp_cache_t* cache = optparse_rsp_cache_new(1 << 20);
+    std::atomic<int>      good(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            char* argv[] = {const_cast<char*>("prog"), const_cast<char*>("@optparse_rsp_g.rsp"), nullptr};
+            for (int k = 0; k < 200; ++k) {
+                optparse_rsp_t rsp;
+                if (optparse_rsp_expand_cached(&rsp, argv, cache) != 0) { return; }
+                optparse_t o;
+                int        a = 0, d = 0;
+                optparse_init(&o, rsp.argv);
+                for (int c; (c = optparse_long(&o, lo, nullptr)) != -1;) {
+                    a += c == 'a';
+                    d += c == 'd' && std::string(o.optarg) == "7";
+                }
+                const bool pos = std::string(optparse_arg(&o)) == "in1" && std::string(optparse_arg(&o)) == "in2";
+                optparse_rsp_free(&rsp);
+                if (a == 2 && d == 1 && pos) { ++good; }
+            }
+        });
+    }
+    for (auto& t : threads) { t.join(); }
+    REQUIRE(good == 8 * 200);
+
+    optparse_rsp_cache_free(cache);
+    std::remove("optparse_rsp_g.rsp");
+}
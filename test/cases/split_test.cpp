@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+/* the buffer ends right at the NUL, so a sanitizer sees any read past it */
+static std::vector<std::string> split(const std::string& input, int* status = nullptr) {
+    std::vector<char>  buf(input.c_str(), input.c_str() + input.size() + 1);
+    std::vector<char*> argv(input.size() + 2);
+
+    const int n = optparse_split(buf.data(), argv.data(), (int)argv.size());
+    if (status) { *status = n; }
+    if (n < 0) { return {}; }
+    REQUIRE(argv[n] == nullptr);
+    return std::vector<std::string>(argv.begin(), argv.begin() + n);
+}
+
+/* byte-at-a-time reference with the same rules, to cross-check the word-at-a-time scan */
+static int split_reference(const std::string& s, std::vector<std::string>& out) {
+    size_t i     = 0;
+    auto   blank = [](char c) { return c == ' ' || c == '\t' || c == '\n'; };
+    for (;;) {
+        while (i < s.size() && blank(s[i])) { ++i; }
+        if (i < s.size() && s[i] == '#') {
+            while (i < s.size() && s[i] != '\n') { ++i; }
+            continue;
+        }
+        if (i == s.size()) { return 0; }
+        std::string word;
+        while (i < s.size() && !blank(s[i])) {
+            const char c = s[i++];
+            if (c == '\\') {
+                if (i == s.size()) {
+                    word += c;
+                } else if (s[i] == '\n') {
+                    ++i;
+                } else {
+                    word += s[i++];
+                }
+            } else if (c == '\'') {
+                const size_t end = s.find('\'', i);
+                if (end == std::string::npos) { return -2; }
+                word += s.substr(i, end - i);
+                i = end + 1;
+            } else if (c == '"') {
+                for (;;) {
+                    if (i == s.size()) { return -2; }
+                    const char d = s[i++];
+                    if (d == '"') { break; }
+                    if (d == '\\' && i < s.size() &&
+                        (s[i] == '$' || s[i] == '`' || s[i] == '"' || s[i] == '\\' || s[i] == '\n')) {
+                        if (s[i] != '\n') { word += s[i]; }
+                        ++i;
+                    } else {
+                        word += d;
+                    }
+                }
+            } else {
+                word += c;
+            }
+        }
+        out.push_back(word);
+    }
+}
+
+TEST_CASE("split: POSIX shell quoting", "[split]") {
+    using V = std::vector<std::string>;
+    /* expectations checked against sh with expansion disabled */
+    REQUIRE(split("run --limit=10 'some file'") == (V{"run", "--limit=10", "some file"}));
+    REQUIRE(split(R"(a\ b "c \"d\" \$e \q" f)") == (V{"a b", R"(c "d" $e \q)", "f"}));
+    REQUIRE(split("  x\t\ty\n z  ") == (V{"x", "y", "z"}));
+    REQUIRE(split(R"('' \"\" x)") == (V{"", "\"\"", "x"}));
+    REQUIRE(split("a\\\nb \"a\\\nb\"") == (V{"ab", "ab"}));
+    REQUIRE(split("one # comment\ntwo") == (V{"one", "two"}));
+    REQUIRE(split("a#b '#c'") == (V{"a#b", "#c"}));
+    REQUIRE(split(R"('it'\''s')") == (V{"it's"}));
+    REQUIRE(split(R"("\\" \\)") == (V{"\\", "\\"}));
+    REQUIRE(split("\xc3\xa9 '\xc3\xbc \xc3\x9f'") == (V{"\xc3\xa9", "\xc3\xbc \xc3\x9f"}));
+    REQUIRE(split("x\\") == (V{"x\\"}));
+    REQUIRE(split("a\rb\x01") == (V{"a\rb\x01"}));
+    REQUIRE(split("").empty());
+    REQUIRE(split(" \t# only a comment").empty());
+}
+
+TEST_CASE("split: errors", "[split][error]") {
+    int status;
+    split("a 'b", &status);
+    REQUIRE(status == -2);
+    split("a \"b\\\"", &status);
+    REQUIRE(status == -2);
+
+    char  text[] = "a b c";
+    char* argv[3];
+    REQUIRE(optparse_split(text, argv, 3) == -1); /* three words need four slots */
+    char  empty[] = "";
+    char* none[1];
+    REQUIRE(optparse_split(empty, none, 1) == 0);
+    REQUIRE(none[0] == nullptr);
+}
+
+TEST_CASE("split: result feeds optparse_init()", "[split]") {
+    static const optparse_long_t lo[] = {
+        {"limit", 'l', OPTPARSE_REQUIRED},
+        {nullptr, 0, OPTPARSE_NONE},
+    };
+    char       line[] = "run --limit=10 'some file'";
+    char*      argv[8];
+    optparse_t o;
+
+    REQUIRE(optparse_split(line, argv, 8) == 3);
+    optparse_init(&o, argv);
+    REQUIRE(optparse_long(&o, lo, nullptr) == 'l');
+    REQUIRE(std::string(o.optarg) == "10");
+    REQUIRE(optparse_long(&o, lo, nullptr) == -1);
+    REQUIRE(std::string(optparse_arg(&o)) == "some file");
+}
+
+TEST_CASE("split: matches the reference on random input", "[split]") {
+    static const char alphabet[] = "aaaaaaaabbbbbbbbcccccccc  \t\n'\"\\#$xyz=-";
+    std::mt19937      rng(1234);
+    for (int iter = 0; iter < 20000; ++iter) {
+        std::string s;
+        const int   len = (int)(rng() % 48);
+        for (int k = 0; k < len; ++k) { s += alphabet[rng() % (sizeof(alphabet) - 1)]; }
+
+        std::vector<std::string> expected;
+        const int                expected_status = split_reference(s, expected);
+
+        /* shift the text so the word loop starts at several alignments */
+        for (size_t shift = 0; shift < sizeof(size_t); shift += 3) {
+            int                      status;
+            std::vector<std::string> got = split(std::string(shift, ' ') + s, &status);
+            REQUIRE(std::min(status, 0) == expected_status);
+            if (status >= 0) { REQUIRE(got == expected); }
+        }
+    }
+}
@@ -0,0 +1,216 @@
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+
+static const optparse_long_t kStreamLongopts[] = {
+    {"amend", 'a', OPTPARSE_NONE},     {"brief", 'b', OPTPARSE_NONE}, {"color", 'c', OPTPARSE_OPTIONAL},
+    {"delay", 'd', OPTPARSE_REQUIRED}, {"erase", 'e', OPTPARSE_NONE}, {nullptr, 0, OPTPARSE_NONE},
+};
+
+/* hands out copies of the arguments through capacity - 1 recycled buffers, the minimum the window allows */
+struct StreamSource {
+    std::vector<std::string> args;
+    size_t                   next = 0;
+    std::vector<std::string> ring;
+    size_t                   slot = 0;
+
+    StreamSource(std::vector<std::string> a, int capacity) : args(std::move(a)), ring(capacity - 1) {}
+
+    static char* pull(void* userdata) {
+        StreamSource* s = static_cast<StreamSource*>(userdata);
+        if (s->next == s->args.size() ) { return nullptr; }
+        std::string& buf = s->ring[s->slot++ % s->ring.size()];
+        buf              = s->args[s->next++];
+        return &buf[0];
+    }
+};
+
+struct StreamEvent {
+    int         r;
+    int         li;
+    std::string optarg;
+    std::string errmsg;
+
+    bool operator==(const StreamEvent& o) const {
+        return r == o.r && li == o.li && optarg == o.optarg && errmsg == o.errmsg;
+    }
+};
+
+static std::vector<StreamEvent> parse_stream(const std::vector<std::string>& args, int capacity, int order) {
+    StreamSource             src(args, capacity);
+    std::vector<char*>       window(capacity);
+    optparse_t               o;
+    optparse_mode_t          mode;
+    std::vector<StreamEvent> events;
+
+    optparse_init_stream(&o, &mode, window.data(), capacity, StreamSource::pull, &src);
+    o.permute = order;
+    for (;;) {
+        int li = -2;
+        int r  = optparse_long(&o, kStreamLongopts, &li);
+        events.push_back({r, li, o.optarg ? o.optarg : "<null>", o.errmsg});
+        if (r == -1) { break; }
+    }
+    for (char* a = optparse_arg(&o); a; a = optparse_arg(&o)) { events.push_back({0, 0, a, ""}); }
+    return events;
+}
+
+static std::vector<StreamEvent> parse_array(const std::vector<std::string>& args, int order) {
+    std::vector<std::string> copy(args);
+    std::vector<char*>       argv;
+    argv.push_back(const_cast<char*>("prog"));
+    for (auto& a : copy) { argv.push_back(&a[0]); }
+    argv.push_back(nullptr);
+
+    optparse_t               o;
+    std::vector<StreamEvent> events;
+    optparse_init(&o, argv.data());
+    o.permute = order;
+    for (;;) {
+        int li = -2;
+        int r  = optparse_long(&o, kStreamLongopts, &li);
+        events.push_back({r, li, o.optarg ? o.optarg : "<null>", o.errmsg});
+        if (r == -1) { break; }
+    }
+    for (char* a = optparse_arg(&o); a; a = optparse_arg(&o)) { events.push_back({0, 0, a, ""}); }
+    return events;
+}
+
+TEST_CASE("stream: same results as an in-order argv parse", "[stream]") {
+    const std::vector<std::vector<std::string>> cases = {
+        {"x", "-ab", "--delay", "10", "y", "-cblue", "--color", "-d", "5", "z"},
+        {"-d", "1", "-d", "2", "-d3", "--delay=4", "-abe", "-abd", "7", "--", "-a", "tail"},
+        {"--bogus", "-z", "--amend=1", "-a"},
+        {"-a", "-d"},
+        {"--delay"},
+        {},
+        {"--", "--", "-a"},
+    };
+    for (int order : {(int)OPTPARSE_RETURN_IN_ORDER, (int)OPTPARSE_REQUIRE_ORDER}) {
+        for (const auto& args : cases) {
+            const auto expected = parse_array(args, order);
+            for (int capacity : {4, 5, 8, 64}) { REQUIRE(parse_stream(args, capacity, order) == expected); }
+        }
+    }
+}
+
+TEST_CASE("stream: permute falls back to in-order", "[stream]") {
+    const std::vector<std::string> args = {"x", "-a", "y"};
+    REQUIRE(parse_stream(args, 4, OPTPARSE_PERMUTE) == parse_array(args, OPTPARSE_RETURN_IN_ORDER));
+}
+
+TEST_CASE("stream: long stream in a fixed window", "[stream]") {
+    std::vector<std::string> args;
+    for (int i = 0; i < 100000; ++i) {
+        switch (i % 4) {
+            case 0: args.push_back("-ab"); break;
+            case 1: args.push_back("--delay"); break;
+            case 2: args.push_back(std::to_string(i)); break;
+            default: args.push_back("file" + std::to_string(i)); break;
+        }
+    }
+
+    StreamSource    src(args, 6);
+    char*           window[6];
+    optparse_t      o;
+    optparse_mode_t mode;
+    long            a = 0, d = 0, pos = 0;
+    optparse_init_stream(&o, &mode, window, 6, StreamSource::pull, &src);
+    for (int r; (r = optparse_long(&o, kStreamLongopts, nullptr)) != -1;) {
+        REQUIRE(r != '?');
+        REQUIRE(o.optind < 6);
+        if (r == 'a') { ++a; }
+        if (r == 'd') {
+            REQUIRE(std::string(o.optarg) == std::to_string(d * 4 + 2));
+            ++d;
+        }
+        if (r == 1) { ++pos; }
+    }
+    REQUIRE(a == 25000);
+    REQUIRE(d == 25000);
+    REQUIRE(pos == 25000);
+}
+
+TEST_CASE("stream: arguments after a POSIX-mode stop", "[stream]") {
+    StreamSource    src({"-a", "cmd", "-b", "--", "x"}, 4);
+    char*           window[4];
+    optparse_t      o;
+    optparse_mode_t mode;
+
+    optparse_init_stream(&o, &mode, window, 4, StreamSource::pull, &src);
+    o.permute = OPTPARSE_REQUIRE_ORDER;
+    REQUIRE(optparse_long(&o, kStreamLongopts, nullptr) == 'a');
+    REQUIRE(optparse_long(&o, kStreamLongopts, nullptr) == -1);
+    REQUIRE(std::string(optparse_arg(&o)) == "cmd");
+
+    /* continue with the sub-command's options from the same stream */
+    REQUIRE(optparse_long(&o, kStreamLongopts, nullptr) == 'b');
+    REQUIRE(optparse_long(&o, kStreamLongopts, nullptr) == -1);
+    REQUIRE(std::string(optparse_arg(&o)) == "x");
+    REQUIRE(optparse_arg(&o) == nullptr);
+    REQUIRE(optparse_long(&o, kStreamLongopts, nullptr) == -1);
+}
+
+static std::string blob_of(const std::vector<std::string>& args) {
+    std::string blob;
+    for (const auto& a : args) { blob.append(a).push_back('\0'); }
+    return blob;
+}
+
+TEST_CASE("buffer: same results as an argv parse", "[stream][buffer]") {
+    const std::vector<std::vector<std::string>> cases = {
+        {"prog", "x", "-ab", "--delay", "10", "y", "-cblue", "--color", "-d", "5", "z"},
+        {"prog", "--delay=a-rather-long-argument-spanning-several-words", "", "-d", "", "--", "-a"},
+        {"prog", "-a", "-d"},
+        {"prog"},
+    };
+    for (const auto& args : cases) {
+        const std::vector<std::string> tail(args.begin() + 1, args.end());
+        const auto                     expected = parse_array(tail, OPTPARSE_RETURN_IN_ORDER);
+
+        /* every start alignment, so the word loop sees unaligned heads and tails */
+        for (size_t shift = 0; shift < 8; ++shift) {
+            std::string        storage = std::string(shift, 'x') + blob_of(args);
+            char*              buf     = &storage[shift];
+            std::vector<char*> window(4);
+            optparse_t         o;
+            optparse_mode_t    mode;
+            optparse_init_buffer(&o, &mode, window.data(), 4, buf, storage.size() - shift);
+            REQUIRE(std::string(window[0]) == "prog");
+
+            std::vector<StreamEvent> events;
+            for (;;) {
+                int li = -2;
+                int r  = optparse_long(&o, kStreamLongopts, &li);
+                events.push_back({r, li, o.optarg ? o.optarg : "<null>", o.errmsg});
+                if (r == -1) { break; }
+            }
+            for (char* a = optparse_arg(&o); a; a = optparse_arg(&o)) {
+                REQUIRE(a >= buf);
+                events.push_back({0, 0, a, ""});
+            }
+            REQUIRE(events == expected);
+        }
+    }
+}
+
+TEST_CASE("buffer: empty blob and unterminated tail", "[stream][buffer]") {
+    char*           win[4];
+    optparse_t      o;
+    optparse_mode_t mode;
+
+    optparse_init_buffer(&o, &mode, win, 4, nullptr, 0);
+    REQUIRE(win[0] == nullptr);
+    REQUIRE(optparse_long(&o, kStreamLongopts, nullptr) == -1);
+
+    char blob[] = {'p', '\0', '-', 'a', '\0', '-', 'b'};
+    optparse_init_buffer(&o, &mode, win, 4, blob, sizeof(blob));
+    REQUIRE(optparse_long(&o, kStreamLongopts, nullptr) == 'a');
+    REQUIRE(optparse_long(&o, kStreamLongopts, nullptr) == -1);
+    REQUIRE(optparse_arg(&o) == nullptr);
+}
@@ -59,3 +59,167 @@ TEST_CASE("stress: recursion depth with optparse_long", "[stress]") {
         REQUIRE(options.optind == 2);
     }
 }
+
+TEST_CASE("stress: interleaved options and positionals permute in blocks", "[stress]") {
+    const int num_pairs = 100000;
+
+    std::vector<std::string> args;
+    args.push_back("prog");
+    for (int i = 0; i < num_pairs; ++i) {
+        args.push_back("arg" + std::to_string(i));
+        switch (i % 4) {
+            case 0: args.push_back("-a"); break;
+            case 1: args.push_back("-f"), args.push_back("val" + std::to_string(i)); break;
+            case 2: args.push_back("--file=val" + std::to_string(i)); break;
+            case 3: args.push_back("--all"); break;
+        }
+    }
+
+    std::vector<char*> argv;
+    for (const auto& s : args) { argv.push_back(const_cast<char*>(s.c_str())); }
+    argv.push_back(nullptr);
+
+    const optparse_long_t longopts[] = {
+        {"all", 'a', OPTPARSE_NONE},
+        {"file", 'f', OPTPARSE_REQUIRED},
+        {nullptr, 0, OPTPARSE_NONE},
+    };
+
+    optparse_t options;
+    optparse_init(&options, argv.data());
+
+    int all = 0, files = 0, result;
+    while ((result = optparse_long(&options, longopts, nullptr)) != -1) {
+        REQUIRE((result == 'a' || result == 'f'));
+        if (result == 'a') {
+            ++all;
+        } else {
+            REQUIRE(std::string(options.optarg).compare(0, 3, "val") == 0);
+            ++files;
+        }
+    }
+    REQUIRE(all == num_pairs / 2);
+    REQUIRE(files == num_pairs / 2);
+    REQUIRE(options.optind == 1 + num_pairs + num_pairs / 4);
+
+    for (int i = 0; i < num_pairs; ++i) {
+        char* arg = optparse_arg(&options);
+        REQUIRE(arg != nullptr);
+        REQUIRE(arg == args[1 + i + i + (i + 2) / 4]);  // pointer identity, original order
+    }
+    REQUIRE(optparse_arg(&options) == nullptr);
+}
+
+TEST_CASE("stress: interleaved blocks with trailing double-dash", "[stress]") {
+    const int num_blocks = 2000;
+    const int block_size = 25;
+
+    std::vector<std::string> args;
+    std::vector<std::string> expected;
+    args.push_back("prog");
+    for (int b = 0; b < num_blocks; ++b) {
+        for (int k = 0; k < block_size; ++k) {
+            args.push_back("p" + std::to_string(b) + "." + std::to_string(k));
+            expected.push_back(args.back());
+        }
+        for (int k = 0; k < block_size; ++k) { args.push_back("-xy"); }
+    }
+    args.push_back("--");
+    args.push_back("-x");
+    expected.push_back("-x");
+
+    std::vector<char*> argv;
+    for (const auto& s : args) { argv.push_back(const_cast<char*>(s.c_str())); }
+    argv.push_back(nullptr);
+
+    optparse_t options;
+    optparse_init(&options, argv.data());
+
+    int count = 0, result;
+    while ((result = optparse(&options, "xy")) != -1) {
+        REQUIRE((result == 'x' || result == 'y'));
+        ++count;
+    }
+    REQUIRE(count == 2 * num_blocks * block_size);
+    REQUIRE(options.optind == 1 + num_blocks * block_size + 1);
+    REQUIRE(std::string(argv[options.optind - 1]) == "--");
+
+    std::vector<std::string> rest;
+    for (char* a = optparse_arg(&options); a; a = optparse_arg(&options)) { rest.push_back(a); }
+    REQUIRE(rest == expected);
+}
+
+TEST_CASE("stress: permuted argv parses the same way again", "[stress]") {
+    SECTION("options keep their arguments and order") {
+        const char* src[] = {"prog", "a", "-o", "val", "b", "-x", "c", nullptr};
+        char*       argv[8];
+        for (int i = 0; i < 8; ++i) { argv[i] = const_cast<char*>(src[i]); }
+
+        optparse_t options;
+        optparse_init(&options, argv);
+        while (optparse(&options, "o:x") != -1) {}
+        REQUIRE(options.optind == 4);
+
+        const char* expected[] = {"prog", "-o", "val", "-x", "a", "b", "c"};
+        for (int i = 0; i < 7; ++i) { REQUIRE(std::string(argv[i]) == expected[i]); }
+    }
+
+    SECTION("thousands of interleaved options and positionals") {
+        std::vector<std::string> args;
+        args.push_back("prog");
+        for (int i = 0; i < 6000; ++i) {
+            const std::string n = std::to_string(i);
+            switch (i % 5) {
+                case 0: args.push_back("p" + n); break;
+                case 1: args.push_back("-o"), args.push_back("v" + n); break;
+                case 2: args.push_back("-xo"), args.push_back("v" + n); break;
+                case 3: args.push_back("--out"), args.push_back("v" + n); break;
+                case 4: args.push_back((i / 5) % 3 ? "p" + n : "-x"); break;
+            }
+            if (i % 97 == 0) {
+                for (int k = 0; k < i % 13; ++k) { args.push_back("q" + n + "." + std::to_string(k)); }
+            }
+        }
+
+        std::vector<char*> argv;
+        for (const auto& s : args) { argv.push_back(const_cast<char*>(s.c_str())); }
+        argv.push_back(nullptr);
+
+        const optparse_long_t longopts[] = {
+            {"out", 'o', OPTPARSE_REQUIRED},
+            {nullptr, 'x', OPTPARSE_NONE},
+            {nullptr, 0, OPTPARSE_NONE},
+        };
+
+        std::vector<std::string> first;
+        optparse_t               options;
+        optparse_init(&options, argv.data());
+        for (int r; (r = optparse_long(&options, longopts, nullptr)) != -1;) {
+            REQUIRE((r == 'o' || r == 'x'));
+            first.push_back(std::string(1, (char)r) + (options.optarg ? options.optarg : ""));
+        }
+        const int optind = options.optind;
+
+        std::vector<std::string> rest;
+        for (char* a = optparse_arg(&options); a; a = optparse_arg(&options)) { rest.push_back(a); }
+
+        // every option is followed by its own argument, in the order the options were given
+        std::vector<std::string> again;
+        optparse_init(&options, argv.data());
+        for (int r; (r = optparse_long(&options, longopts, nullptr)) != -1;) {
+            if (r == 'o') { REQUIRE(std::string(argv[options.optind - 1]) == options.optarg); }
+            again.push_back(std::string(1, (char)r) + (options.optarg ? options.optarg : ""));
+        }
+        REQUIRE(again == first);
+        REQUIRE(options.optind == optind);
+
+        std::vector<std::string> positionals;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (args[i][0] != '-' && args[i - 1] != "-o" && args[i - 1] != "-xo" && args[i - 1] != "--out") {
+                positionals.push_back(args[i]);
+            }
+        }
+        REQUIRE(rest == positionals);
+        for (size_t i = 0; i < rest.size(); ++i) { REQUIRE(argv[optind + i] == rest[i]); }
+    }
+}
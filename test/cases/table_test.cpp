@@ -0,0 +1,111 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#define OPTPARSE_API static
+#define OPTPARSE_IMPLEMENTATION
+#include "optparse/optparse.h"
+#include "optparse/optparse.hpp"
+#include "parse_all.hpp"
+
+static constexpr optparse_long_t kTableLongopts[] = {
+    {"verbose", 'v', OPTPARSE_NONE},
+    {"output", 'o', OPTPARSE_REQUIRED},
+    {"color", 'c', OPTPARSE_OPTIONAL},
+    {"out", 256, OPTPARSE_NONE},
+    {nullptr, 'q', OPTPARSE_NONE},
+    {"a=b", 257, OPTPARSE_NONE},
+    {"", 258, OPTPARSE_NONE},
+    {"jobs", 'j', OPTPARSE_REQUIRED},
+    {"dry-run", 'n', OPTPARSE_NONE},
+    {"force", 'f', OPTPARSE_NONE},
+    {"include", 'I', OPTPARSE_REQUIRED},
+    {"define", 'D', OPTPARSE_REQUIRED},
+    {"undefine", 'U', OPTPARSE_REQUIRED},
+    {"keep-going", 'k', OPTPARSE_NONE},
+    {"silent", 's', OPTPARSE_NONE},
+    {"quiet", 259, OPTPARSE_NONE},
+    {"directory", 'C', OPTPARSE_REQUIRED},
+    {"file", 'F', OPTPARSE_REQUIRED},
+    {"makefile", 260, OPTPARSE_REQUIRED},
+    {"load-average", 'l', OPTPARSE_OPTIONAL},
+    {"max-load", 261, OPTPARSE_OPTIONAL},
+    {"print-directory", 'w', OPTPARSE_NONE},
+    {"no-print-directory", 262, OPTPARSE_NONE},
+    {"trace", 263, OPTPARSE_NONE},
+    {"touch", 't', OPTPARSE_NONE},
+    {"what-if", 'W', OPTPARSE_REQUIRED},
+    {"new-file", 264, OPTPARSE_REQUIRED},
+    {"assume-new", 265, OPTPARSE_REQUIRED},
+    {"old-file", 266, OPTPARSE_REQUIRED},
+    {"assume-old", 267, OPTPARSE_REQUIRED},
+    {"question", 268, OPTPARSE_NONE},
+    {"environment-overrides", 'e', OPTPARSE_NONE},
+    {"debug", 'd', OPTPARSE_OPTIONAL},
+    {"version", 'V', OPTPARSE_NONE},
+    {"help", 'h', OPTPARSE_NONE},
+    {nullptr, 0, OPTPARSE_NONE},
+};
+
+typedef OPTPARSE_TABLE(kTableLongopts) Table;
+
+static std::vector<std::string> parse_both(const std::vector<std::string>& args, bool table) {
+    return parse_all(args, [&](optparse_t* o, int* li) {
+        return table ? Table::parse(o, li) : optparse_long(o, kTableLongopts, li);
+    });
+}
+
+TEST_CASE("table: every name resolves to its own entry", "[table]") {
+    REQUIRE(Table::count == 35);
+    REQUIRE(Table::named == 34);
+    for (int i = 0; i < Table::count; ++i) {
+        const char* name = kTableLongopts[i].longname;
+        if (!name || std::string(name).find('=') != std::string::npos) { continue; }
+        REQUIRE(Table::find(nullptr, name) == i);
+        REQUIRE(Table::find(nullptr, (std::string(name) + "=value").c_str()) == i);
+        REQUIRE(Table::find(nullptr, (std::string(name) + "x").c_str()) == -1);
+        if (name[0]) { REQUIRE(Table::find(nullptr, std::string(name).substr(1).c_str()) == -1); }
+    }
+    REQUIRE(Table::find(nullptr, "a=b") == -1); /* the '=' always ends the name */
+    REQUIRE(Table::shortidx.v['q'] == 4);
+    REQUIRE(Table::shortidx.v['z'] == -1);
+}
+
+TEST_CASE("table: same results as optparse_long()", "[table]") {
+    static const char* pool[] = {
+        "-v", "-o", "x", "--output=y", "--color", "--color=z", "-cz", "--out", "-q", "--a=b", "--=", "--", "-",
+        "--jobs", "--jobs=", "-vj4", "--verbose", "--verbos", "--verbosee", "--help=1", "-Z", "--debug", "--trace",
+        "--quiet", "--max-load=2", "-l", "--file",
+    };
+    std::mt19937 rng(21);
+    for (int iter = 0; iter < 3000; ++iter) {
+        std::vector<std::string> args = {"prog"};
+        const int                n    = (int)(rng() % 10);
+        for (int k = 0; k < n; ++k) { args.push_back(pool[rng() % (sizeof(pool) / sizeof(pool[0]))]); }
+        REQUIRE(parse_both(args, true) == parse_both(args, false));
+    }
+}
+
+static constexpr optparse_long_t kTableOne[]    = {{"only", 'o', OPTPARSE_REQUIRED}, {nullptr, 0, OPTPARSE_NONE}};
+static constexpr optparse_long_t kTableShorts[] = {{nullptr, 'a', OPTPARSE_NONE}, {nullptr, 0, OPTPARSE_NONE}};
+
+TEST_CASE("table: tiny and short-only tables", "[table]") {
+    typedef OPTPARSE_TABLE(kTableOne) One;
+    typedef OPTPARSE_TABLE(kTableShorts) Shorts;
+
+    char*      argv[] = {(char*)"prog", (char*)"--only=1", (char*)"--onl", (char*)"-a", nullptr};
+    optparse_t o;
+    optparse_init(&o, argv);
+    REQUIRE(One::parse(&o, nullptr) == 'o');
+    REQUIRE(std::string(o.optarg) == "1");
+    REQUIRE(One::parse(&o, nullptr) == '?');
+    REQUIRE(One::parse(&o, nullptr) == '?');
+
+    optparse_init(&o, argv);
+    REQUIRE(Shorts::parse(&o, nullptr) == '?');
+    REQUIRE(Shorts::parse(&o, nullptr) == '?');
+    REQUIRE(Shorts::parse(&o, nullptr) == 'a');
+    REQUIRE(Shorts::parse(&o, nullptr) == -1);
+}
@@ -0,0 +1,48 @@
+#ifndef OPTPARSE_TEST_PARSE_ALL_HPP
+#define OPTPARSE_TEST_PARSE_ALL_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "optparse/optparse.h"
+
+/* sets up @p options over @p argv, which is NULL-terminated */
+typedef std::function<void(optparse_t* options, std::vector<char*>& argv)> parse_init_fn;
+/* one parse call; returns what it returned and stores the long index */
+typedef std::function<int(optparse_t* options, int* longindex)> parse_step_fn;
+
+/**
+ * Full parse over @p args (argv[0] first), written out for differential tests:
+ * "result:longindex:optind:optarg:errmsg" per call up to -1, then the
+ * positionals left for optparse_arg(), then the result of one more call.
+ * Without @p init the parser is set up with optparse_init().
+ */
+static inline std::vector<std::string> parse_all(std::vector<std::string> args, const parse_step_fn& step,
+                                                 const parse_init_fn& init = nullptr) {
+    std::vector<char*> argv;
+    for (auto& a : args) { argv.push_back(&a[0]); }
+    argv.push_back(nullptr);
+
+    optparse_t options;
+    if (init) {
+        init(&options, argv);
+    } else {
+        optparse_init(&options, argv.data());
+    }
+
+    std::vector<std::string> out;
+    for (;;) {
+        int       longindex = -2;
+        const int r         = step(&options, &longindex);
+        out.push_back(std::to_string(r) + ":" + std::to_string(longindex) + ":" + std::to_string(options.optind) +
+                      ":" + (options.optarg ? options.optarg : "<null>") + ":" + options.errmsg);
+        if (r == -1) { break; }
+    }
+    for (char* a; (a = optparse_arg(&options)) != nullptr;) { out.push_back(a); }
+    int longindex = -2;
+    out.push_back(std::to_string(step(&options, &longindex))); /* finished parsers stay finished */
+    return out;
+}
+
+#endif